@@ -29,7 +29,7 @@ EOS
 # Parse options
 ########################################################################################
 
-while getopts n:h OPT
+while getopts N:h OPT
 do
   case ${OPT} in
     N) NUMA_NODES=${OPTARG}
@@ -80,7 +80,16 @@ for IMPL in ${IMPL_CANDIDATES}; do
         echo -n "${IMPL},${SKEW_PARAMETER},${THREAD_NUM},"
         ${BENCH_BIN} \
           --csv --throughput=f ${IMPL_ARGS} --num-init-thread ${INIT_THREAD_NUM} \
-          --num-field ${TARGET_FIELD_NUM} --num_exec ${OPERATION_COUNT} \
+          --num-field ${TARGET_FIELD_NUM} --field_stride ${FIELD_STRIDE} \
+          --record_size ${RECORD_SIZE} --word_offset ${WORD_OFFSET} \
+          --payload_touch_bytes ${PAYLOAD_TOUCH_BYTES} \
+          --key_dist ${KEY_DIST} --width_dist=${WIDTH_DIST} --key_layout ${KEY_LAYOUT} \
+          --read_ratio ${READ_RATIO} --zipf_sampler ${ZIPF_SAMPLER} \
+          --update_kind ${UPDATE_KIND} --think_cycles ${THINK_CYCLES} --presort=${PRESORT} \
+          --backoff ${BACKOFF} --descriptor_stats=${DESCRIPTOR_STATS} \
+          --op_stats=${OP_STATS} --timing_stats=${TIMING_STATS} \
+          --field_numa_policy ${FIELD_NUMA_POLICY} \
+          --huge_pages ${HUGE_PAGES} --num_exec ${OPERATION_COUNT} --num_warmup ${WARMUP_COUNT} \
           --num_thread ${THREAD_NUM} --skew_parameter ${SKEW_PARAMETER}
       done
     done
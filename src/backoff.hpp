@@ -0,0 +1,246 @@
+/*
+ * Copyright 2021 Database Group, Nagoya University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MWCAS_BENCHMARK_BACKOFF_H
+#define MWCAS_BENCHMARK_BACKOFF_H
+
+#include <sched.h>
+#include <x86intrin.h>
+
+#include <algorithm>
+#include <string>
+
+#include "common.hpp"
+
+/*##################################################################################################
+ * Global enums
+ *################################################################################################*/
+
+/**
+ * @brief Contention-management policies between failed MwCAS attempts.
+ *
+ */
+enum BackoffPolicy
+{
+  /// retry immediately
+  kNoBackoff,
+  /// spin for exponentially increasing (and bounded) periods
+  kExponentialBackoff,
+  /// spin for random periods within exponentially increasing windows
+  kRandomizedBackoff,
+  /// yield the CPU to other threads
+  kYieldBackoff,
+  /// spin within a window that each thread adapts to recent contention
+  kAdaptiveBackoff,
+};
+
+/**
+ * @brief Utilities shared by contention-management policies.
+ *
+ * Each policy is a class with the following member functions, and a policy object is created
+ * for each operation.
+ *
+ * - `void Wait()`: called after each failed attempt.
+ * - `void Complete()`: called when an operation completes.
+ */
+class Backoff
+{
+ public:
+  /*################################################################################################
+   * Public constants
+   *##############################################################################################*/
+
+  /// the number of pause instructions in the first backoff
+  static constexpr size_t kMinSpins = 4;
+
+  /// the maximum number of pause instructions in one backoff
+  static constexpr size_t kMaxSpins = 4096;
+
+  /*################################################################################################
+   * Public utility functions
+   *##############################################################################################*/
+
+  /**
+   * @brief Spin with pause instructions to release pipeline resources to sibling threads.
+   *
+   * @param spin_num the number of pause instructions.
+   */
+  static void
+  Spin(const size_t spin_num)
+  {
+    for (size_t i = 0; i < spin_num; ++i) {
+      _mm_pause();
+    }
+  }
+
+  /**
+   * @return a pseudo-random number from a cheap per-thread generator (xorshift).
+   */
+  static size_t
+  Random()
+  {
+    thread_local size_t x = reinterpret_cast<size_t>(&x) | 1UL;
+    x ^= x << 13UL;
+    x ^= x >> 7UL;
+    x ^= x << 17UL;
+    return x;
+  }
+
+  /**
+   * @brief Parse a backoff policy string.
+   *
+   * @param str a policy string ("none", "exponential", "randomized", "yield", or "adaptive").
+   * @param policy a parsed policy.
+   * @retval true if the string is valid.
+   * @retval false otherwise.
+   */
+  static bool
+  Parse(  //
+      const std::string &str,
+      BackoffPolicy &policy)
+  {
+    if (str == "none") {
+      policy = kNoBackoff;
+    } else if (str == "exponential") {
+      policy = kExponentialBackoff;
+    } else if (str == "randomized") {
+      policy = kRandomizedBackoff;
+    } else if (str == "yield") {
+      policy = kYieldBackoff;
+    } else if (str == "adaptive") {
+      policy = kAdaptiveBackoff;
+    } else {
+      return false;
+    }
+    return true;
+  }
+};
+
+/**
+ * @brief A policy to retry immediately (i.e., the behavior without contention management).
+ *
+ */
+class NoBackoff
+{
+ public:
+  constexpr void
+  Wait()
+  {
+  }
+
+  constexpr void
+  Complete()
+  {
+  }
+};
+
+/**
+ * @brief A policy to spin for bounded exponential periods.
+ *
+ */
+class ExponentialBackoff
+{
+ public:
+  void
+  Wait()
+  {
+    Backoff::Spin(spin_num_);
+    spin_num_ = std::min(spin_num_ * 2, Backoff::kMaxSpins);
+  }
+
+  constexpr void
+  Complete()
+  {
+  }
+
+ private:
+  /// the number of pause instructions in the next backoff
+  size_t spin_num_{Backoff::kMinSpins};
+};
+
+/**
+ * @brief A policy to spin for random periods within bounded exponential windows.
+ *
+ * Randomization prevents threads that failed together from retrying together.
+ */
+class RandomizedBackoff
+{
+ public:
+  void
+  Wait()
+  {
+    Backoff::Spin(Backoff::Random() & (window_ - 1));
+    window_ = std::min(window_ * 2, Backoff::kMaxSpins);
+  }
+
+  constexpr void
+  Complete()
+  {
+  }
+
+ private:
+  /// the window of random backoff periods (a power of two)
+  size_t window_{Backoff::kMinSpins};
+};
+
+/**
+ * @brief A policy to yield the CPU after each failure.
+ *
+ */
+class YieldBackoff
+{
+ public:
+  void
+  Wait()
+  {
+    sched_yield();
+  }
+
+  constexpr void
+  Complete()
+  {
+  }
+};
+
+/**
+ * @brief A policy to spin for random periods within a window adapted to recent contention.
+ *
+ * Each thread keeps its window across operations: the window doubles on a failure and halves
+ * when an operation completes. Thus, threads under heavy contention back off from the first
+ * failure, and the window shrinks again when contention decreases.
+ */
+class AdaptiveBackoff
+{
+ public:
+  void
+  Wait()
+  {
+    Backoff::Spin(Backoff::Random() & (window_ - 1));
+    window_ = std::min(window_ * 2, Backoff::kMaxSpins);
+  }
+
+  void
+  Complete()
+  {
+    window_ = std::max(window_ / 2, Backoff::kMinSpins);
+  }
+
+ private:
+  /// the window of random backoff periods in a calling thread (a power of two)
+  static inline thread_local size_t window_{Backoff::kMinSpins};
+};
+
+#endif  // MWCAS_BENCHMARK_BACKOFF_H
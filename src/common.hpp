@@ -42,4 +42,11 @@ using SingleCAS = ::std::atomic_size_t;
 /// the maximum number of MwCAS targets
 constexpr size_t kTargetNum = MWCAS_BENCH_TARGET_NUM;
 
+/// a flag to compile the code to count failed MwCAS attempts
+#ifdef MWCAS_BENCH_DISABLE_RETRY_STATS
+constexpr bool kRetryStats = false;
+#else
+constexpr bool kRetryStats = true;
+#endif
+
 #endif  // MWCAS_BENCHMARK_COMMON_H
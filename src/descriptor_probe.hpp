@@ -0,0 +1,215 @@
+/*
+ * Copyright 2021 Database Group, Nagoya University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MWCAS_BENCHMARK_DESCRIPTOR_PROBE_H
+#define MWCAS_BENCHMARK_DESCRIPTOR_PROBE_H
+
+#include "common.hpp"
+#include "operation.hpp"
+
+/**
+ * @brief A probe to count target words that hold in-progress MwCAS descriptors.
+ *
+ * The libraries do not expose whether their procedures help, spin, or back off when they find
+ * a descriptor, so the harness peeks at raw target words just before a library reads them and
+ * just after a library fails to commit. Descriptor words are identified by flags in the most
+ * significant bits, which benchmark values never use (see UpdateFunction::kVersionShift).
+ */
+class DescriptorProbe
+{
+ public:
+  /*################################################################################################
+   * Public constants
+   *##############################################################################################*/
+
+  /// the lowest bit of flags that MwCAS implementations embed in target words
+  static constexpr size_t kFlagShift = 60;
+
+  /// a mask to extract the flags of a target word
+  static constexpr size_t kFlagMask = ~((1UL << kFlagShift) - 1);
+
+  /*################################################################################################
+   * Public getters
+   *##############################################################################################*/
+
+  /**
+   * @return the number of peeked read operations.
+   */
+  constexpr size_t
+  GetReadNum() const
+  {
+    return read_num_;
+  }
+
+  /**
+   * @return the number of read operations that found at least one descriptor.
+   */
+  constexpr size_t
+  GetReadHitNum() const
+  {
+    return read_hit_num_;
+  }
+
+  /**
+   * @return the number of peeked update attempts.
+   */
+  constexpr size_t
+  GetAttemptNum() const
+  {
+    return attempt_num_;
+  }
+
+  /**
+   * @return the number of update attempts that found at least one descriptor.
+   */
+  constexpr size_t
+  GetAttemptHitNum() const
+  {
+    return attempt_hit_num_;
+  }
+
+  /**
+   * @return the total number of descriptor words found before reads.
+   */
+  constexpr size_t
+  GetWordHitNum() const
+  {
+    return word_hit_num_;
+  }
+
+  /**
+   * @return the number of failed commits.
+   */
+  constexpr size_t
+  GetFailureNum() const
+  {
+    return failure_num_;
+  }
+
+  /**
+   * @return the number of failed commits that left at least one descriptor in their targets.
+   */
+  constexpr size_t
+  GetFailureHitNum() const
+  {
+    return failure_hit_num_;
+  }
+
+  /*################################################################################################
+   * Public utility functions
+   *##############################################################################################*/
+
+  /**
+   * @param word the raw value of a target word.
+   * @retval true if the word holds a descriptor (i.e., an MwCAS operation is in progress).
+   * @retval false otherwise.
+   */
+  static constexpr bool
+  IsDescriptor(const size_t word)
+  {
+    return (word & kFlagMask) != 0;
+  }
+
+  /**
+   * @param ops target addresses of an operation.
+   * @return the number of target words that currently hold descriptors.
+   */
+  static size_t
+  CountDescriptors(const Operation &ops)
+  {
+    size_t count = 0;
+    for (size_t i = 0; i < ops.GetWidth(); ++i) {
+      count += IsDescriptor(__atomic_load_n(ops.GetAddr(i), __ATOMIC_RELAXED));
+    }
+    return count;
+  }
+
+  /**
+   * @brief Add the counts of another probe (e.g., to aggregate the probes of workers).
+   *
+   * @param probe another probe.
+   */
+  void
+  Merge(const DescriptorProbe &probe)
+  {
+    read_num_ += probe.read_num_;
+    read_hit_num_ += probe.read_hit_num_;
+    attempt_num_ += probe.attempt_num_;
+    attempt_hit_num_ += probe.attempt_hit_num_;
+    word_hit_num_ += probe.word_hit_num_;
+    failure_num_ += probe.failure_num_;
+    failure_hit_num_ += probe.failure_hit_num_;
+  }
+
+  /**
+   * @brief Peek at target words just before reading them in a read or an update attempt.
+   *
+   * @param ops target addresses of an operation.
+   */
+  void
+  PeekRead(const Operation &ops)
+  {
+    const auto count = CountDescriptors(ops);
+    word_hit_num_ += count;
+    if (ops.GetType() == kRead) {
+      ++read_num_;
+      if (count > 0) ++read_hit_num_;
+    } else {
+      ++attempt_num_;
+      if (count > 0) ++attempt_hit_num_;
+    }
+  }
+
+  /**
+   * @brief Peek at target words just after a failed commit.
+   *
+   * @param ops target addresses of an MwCAS operation.
+   */
+  void
+  PeekFailure(const Operation &ops)
+  {
+    ++failure_num_;
+    if (CountDescriptors(ops) > 0) ++failure_hit_num_;
+  }
+
+ private:
+  /*################################################################################################
+   * Internal member variables
+   *##############################################################################################*/
+
+  /// the number of peeked read operations
+  size_t read_num_{0};
+
+  /// the number of read operations that found descriptors
+  size_t read_hit_num_{0};
+
+  /// the number of peeked update attempts
+  size_t attempt_num_{0};
+
+  /// the number of update attempts that found descriptors
+  size_t attempt_hit_num_{0};
+
+  /// the total number of descriptor words found before reads
+  size_t word_hit_num_{0};
+
+  /// the number of failed commits
+  size_t failure_num_{0};
+
+  /// the number of failed commits that left descriptors in their targets
+  size_t failure_hit_num_{0};
+};
+
+#endif  // MWCAS_BENCHMARK_DESCRIPTOR_PROBE_H
@@ -0,0 +1,443 @@
+/*
+ * Copyright 2021 Database Group, Nagoya University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MWCAS_BENCHMARK_KEY_DISTRIBUTION_H
+#define MWCAS_BENCHMARK_KEY_DISTRIBUTION_H
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <string>
+
+#include "common.hpp"
+#include "random/zipf.hpp"
+#include "width_distribution.hpp"
+#include "zipf_sampler.hpp"
+
+/*##################################################################################################
+ * Global enums
+ *################################################################################################*/
+
+/**
+ * @brief Distributions to select the ranks of target fields.
+ *
+ */
+enum KeyDistType
+{
+  /// ranks follow Zipf's law
+  kZipf,
+  /// every rank is selected with the same probability
+  kUniform,
+  /// a fixed ratio of operations access a fixed ratio of top ranks
+  kHotspot,
+  /// a hotspot that shifts to the next ranks periodically (i.e., "latest" keys are hot)
+  kMovingHotspot,
+  /// ranks follow an exponential distribution
+  kExponential,
+  /// each worker accesses only its own partition of ranks (i.e., no conflicts)
+  kPartitioned,
+  /// each operation accesses a small shared set or a per-worker private set
+  kConflict,
+};
+
+/**
+ * @brief Samplers to select ranks according to Zipf's law.
+ *
+ */
+enum ZipfSamplerType
+{
+  /// binary search on a CDF table with O(n) memory and setup time
+  kZipfTable,
+  /// rejection-inversion with O(1) memory and time per sample
+  kZipfRejectionInversion,
+};
+
+/**
+ * @brief A class to select the ranks of target fields according to a key distribution.
+ *
+ * Ranks are mapped to target fields by a key layout of OperationEngine. All the randomness
+ * comes from a given random engine, and so the results are determined by random seeds.
+ */
+class KeyDistribution
+{
+  /*################################################################################################
+   * Type aliases
+   *##############################################################################################*/
+
+  using ZipfGenerator = ::dbgroup::random::zipf::ZipfGenerator;
+
+ public:
+  /*################################################################################################
+   * Public constructors and assignment operators
+   *##############################################################################################*/
+
+  /**
+   * @brief Construct a new KeyDistribution object.
+   *
+   * @param dist_type the type of a distribution.
+   * @param field_num the total number of target fields.
+   * @param skew_parameter a skew parameter of Zipf's law (zipf and partitioned).
+   * @param hot_op_ratio the ratio of operations that access hot fields.
+   * @param hot_field_ratio the ratio of hot fields in all the fields.
+   * @param hotspot_period the number of operations per worker before a hotspot shifts.
+   * @param exp_lambda the rate of an exponential distribution over normalized ranks.
+   * @param partition_num the number of partitions (i.e., workers).
+   * @param conflict_rate the requested probability that two operations of different workers
+   * share any target field (conflict).
+   * @param shared_field_num the number of fields shared by workers (conflict).
+   * @param zipf_sampler a sampler of Zipf's law (zipf and partitioned).
+   * @param width_dist a distribution of operation widths (conflict).
+   */
+  KeyDistribution(  //
+      const KeyDistType dist_type,
+      const size_t field_num,
+      const double skew_parameter,
+      const double hot_op_ratio,
+      const double hot_field_ratio,
+      const size_t hotspot_period,
+      const double exp_lambda,
+      const size_t partition_num,
+      const double conflict_rate,
+      const size_t shared_field_num,
+      const ZipfSamplerType zipf_sampler = kZipfTable,
+      const WidthDistribution &width_dist = WidthDistribution{WidthDistribution::Weights_t{}})
+      : dist_type_{dist_type},
+        field_num_{field_num},
+        hot_op_ratio_{hot_op_ratio},
+        hot_num_{std::min<size_t>(
+            std::max<size_t>(std::ceil(field_num * hot_field_ratio), kTargetNum), field_num)},
+        hotspot_period_{hotspot_period},
+        exp_lambda_{exp_lambda},
+        shared_num_{(dist_type == kConflict) ? shared_field_num : 0},
+        partition_size_{(field_num - shared_num_) / std::max<size_t>(partition_num, 1)},
+        max_conflict_rate_{ComputeOverlapProbability(width_dist)},
+        shared_op_ratio_{(dist_type == kConflict)
+                             ? std::min(std::sqrt(conflict_rate / max_conflict_rate_), 1.0)
+                             : 0},
+        zipf_sampler_{zipf_sampler},
+        zipf_engine_{UsesZipfTable() ? GetZipfRankNum() : 1, skew_parameter},
+        rejection_engine_{GetZipfRankNum(), skew_parameter}
+  {
+  }
+
+  KeyDistribution(const KeyDistribution &) = default;
+  KeyDistribution &operator=(const KeyDistribution &obj) = default;
+  KeyDistribution(KeyDistribution &&) = default;
+  KeyDistribution &operator=(KeyDistribution &&) = default;
+
+  /*################################################################################################
+   * Public destructors
+   *##############################################################################################*/
+
+  ~KeyDistribution() = default;
+
+  /*################################################################################################
+   * Public getters
+   *##############################################################################################*/
+
+  /**
+   * @return the highest conflict rate that can be achieved (i.e., every operation is shared).
+   */
+  double
+  GetMaxConflictRate() const
+  {
+    return max_conflict_rate_;
+  }
+
+  /**
+   * @return the ratio of operations that access shared fields (conflict).
+   */
+  double
+  GetSharedOpRatio() const
+  {
+    return shared_op_ratio_;
+  }
+
+  /*################################################################################################
+   * Public utility functions
+   *##############################################################################################*/
+
+  /**
+   * @brief Draw randomness shared by all the targets of an operation.
+   *
+   * A random engine is used only if a distribution needs per-operation decisions, so that the
+   * other distributions generate the same operations as without this function.
+   *
+   * @tparam RandEngine the class of a random engine.
+   * @param rand_engine a random engine of a calling worker.
+   * @return a value in [0, 1) to be passed to operator() for each target.
+   */
+  template <class RandEngine>
+  double
+  DrawOperation(RandEngine &rand_engine) const
+  {
+    if (dist_type_ != kConflict) return 0;
+    return std::uniform_real_distribution<double>{0, 1}(rand_engine);
+  }
+
+  /**
+   * @tparam RandEngine the class of a random engine.
+   * @param rand_engine a random engine of a calling worker.
+   * @param worker_id the ID of a calling worker.
+   * @param op_id the sequential number of an operation in the worker.
+   * @param op_draw a value drawn by DrawOperation for the operation.
+   * @return a selected rank in [0, the number of fields).
+   */
+  template <class RandEngine>
+  size_t
+  operator()(  //
+      RandEngine &rand_engine,
+      const size_t worker_id,
+      const size_t op_id,
+      const double op_draw = 0)
+  {
+    switch (dist_type_) {
+      case kUniform:
+        return SelectUniformly(rand_engine, 0, field_num_);
+      case kHotspot:
+        return SelectHotspot(rand_engine);
+      case kMovingHotspot: {
+        const auto shift = (op_id / hotspot_period_) * hot_num_;
+        return (SelectHotspot(rand_engine) + shift) % field_num_;
+      }
+      case kExponential:
+        while (true) {
+          const auto x = std::exponential_distribution<double>{exp_lambda_}(rand_engine);
+          const auto rank = static_cast<size_t>(x * field_num_);
+          if (rank < field_num_) return rank;
+        }
+      case kPartitioned:
+        return (worker_id % GetPartitionNum()) * partition_size_ + SelectZipf(rand_engine);
+      case kConflict: {
+        if (op_draw < shared_op_ratio_) return SelectUniformly(rand_engine, 0, shared_num_);
+        const auto begin = shared_num_ + (worker_id % GetPartitionNum()) * partition_size_;
+        return SelectUniformly(rand_engine, begin, begin + partition_size_);
+      }
+      case kZipf:
+      default:
+        return SelectZipf(rand_engine);
+    }
+  }
+
+  /*################################################################################################
+   * Public static utilities
+   *##############################################################################################*/
+
+  /**
+   * @brief Parse a Zipf sampler string.
+   *
+   * @param str a sampler string ("table" or "rejection_inversion").
+   * @param sampler a parsed sampler.
+   * @retval true if the string is valid.
+   * @retval false otherwise.
+   */
+  static bool
+  Parse(  //
+      const std::string &str,
+      ZipfSamplerType &sampler)
+  {
+    if (str == "table") {
+      sampler = kZipfTable;
+    } else if (str == "rejection_inversion") {
+      sampler = kZipfRejectionInversion;
+    } else {
+      return false;
+    }
+    return true;
+  }
+
+  /**
+   * @brief Parse a key distribution string.
+   *
+   * @param str a distribution string ("zipf", "uniform", "hotspot", "moving_hotspot",
+   * "exponential", "partitioned", or "conflict").
+   * @param dist_type a parsed distribution.
+   * @retval true if the string is valid.
+   * @retval false otherwise.
+   */
+  static bool
+  Parse(  //
+      const std::string &str,
+      KeyDistType &dist_type)
+  {
+    if (str == "zipf") {
+      dist_type = kZipf;
+    } else if (str == "uniform") {
+      dist_type = kUniform;
+    } else if (str == "hotspot") {
+      dist_type = kHotspot;
+    } else if (str == "moving_hotspot") {
+      dist_type = kMovingHotspot;
+    } else if (str == "exponential") {
+      dist_type = kExponential;
+    } else if (str == "partitioned") {
+      dist_type = kPartitioned;
+    } else if (str == "conflict") {
+      dist_type = kConflict;
+    } else {
+      return false;
+    }
+    return true;
+  }
+
+ private:
+  /*################################################################################################
+   * Internal utility functions
+   *##############################################################################################*/
+
+  /**
+   * @return a rank selected uniformly from [begin, end).
+   */
+  template <class RandEngine>
+  static size_t
+  SelectUniformly(  //
+      RandEngine &rand_engine,
+      const size_t begin,
+      const size_t end)
+  {
+    return std::uniform_int_distribution<size_t>{begin, end - 1}(rand_engine);
+  }
+
+  /**
+   * @return a rank selected according to Zipf's law.
+   */
+  template <class RandEngine>
+  size_t
+  SelectZipf(RandEngine &rand_engine)
+  {
+    if (zipf_sampler_ == kZipfRejectionInversion) return rejection_engine_(rand_engine);
+    return zipf_engine_(rand_engine);
+  }
+
+  /**
+   * @return the number of ranks that follow Zipf's law.
+   */
+  size_t
+  GetZipfRankNum() const
+  {
+    return (dist_type_ == kPartitioned) ? partition_size_ : field_num_;
+  }
+
+  /**
+   * @retval true if a CDF table of Zipf's law is used.
+   * @retval false otherwise (i.e., the table is left empty to avoid O(n) setup).
+   */
+  bool
+  UsesZipfTable() const
+  {
+    return zipf_sampler_ == kZipfTable && (dist_type_ == kZipf || dist_type_ == kPartitioned);
+  }
+
+  /**
+   * @return the number of per-worker partitions (partitioned and conflict).
+   */
+  size_t
+  GetPartitionNum() const
+  {
+    return (field_num_ - shared_num_) / partition_size_;
+  }
+
+  /**
+   * @brief Compute the probability that two shared operations select overlapping fields.
+   *
+   * Two operations of different workers conflict only if both are shared and they select
+   * overlapping fields from the shared set. For S shared fields and widths a and b, the latter
+   * occurs with probability 1 - C(S - a, b) / C(S, b), which is averaged over the pairs of
+   * widths. Thus, a shared ratio q results in a conflict rate of q^2 times the average, and
+   * the average is the highest conflict rate.
+   *
+   * @param width_dist a distribution of operation widths.
+   * @return the average probability of overlaps (zero if not conflict).
+   */
+  double
+  ComputeOverlapProbability(const WidthDistribution &width_dist) const
+  {
+    if (dist_type_ != kConflict) return 0;
+
+    double overlap_prob = 0;
+    for (size_t a = 1; a <= kTargetNum; ++a) {
+      const auto prob_a = width_dist.GetProbability(a);
+      if (prob_a == 0) continue;
+      for (size_t b = 1; b <= kTargetNum; ++b) {
+        const auto prob_b = width_dist.GetProbability(b);
+        if (prob_b == 0) continue;
+        double disjoint_prob = (shared_num_ < a + b) ? 0.0 : 1.0;
+        for (size_t i = 0; i < b && disjoint_prob > 0; ++i) {
+          disjoint_prob *= static_cast<double>(shared_num_ - a - i) / (shared_num_ - i);
+        }
+        overlap_prob += prob_a * prob_b * (1.0 - disjoint_prob);
+      }
+    }
+    return overlap_prob;
+  }
+
+  /**
+   * @return a rank in the top ranks with a hot ratio, or a rank in the others otherwise.
+   */
+  template <class RandEngine>
+  size_t
+  SelectHotspot(RandEngine &rand_engine)
+  {
+    const auto is_hot = std::uniform_real_distribution<double>{0, 1}(rand_engine) < hot_op_ratio_;
+    if (is_hot || hot_num_ == field_num_) return SelectUniformly(rand_engine, 0, hot_num_);
+    return SelectUniformly(rand_engine, hot_num_, field_num_);
+  }
+
+  /*################################################################################################
+   * Internal member variables
+   *##############################################################################################*/
+
+  /// the type of a distribution
+  KeyDistType dist_type_;
+
+  /// the total number of target fields
+  size_t field_num_;
+
+  /// the ratio of operations that access hot fields
+  double hot_op_ratio_;
+
+  /// the number of hot fields
+  size_t hot_num_;
+
+  /// the number of operations per worker before a hotspot shifts
+  size_t hotspot_period_;
+
+  /// the rate of an exponential distribution over normalized ranks
+  double exp_lambda_;
+
+  /// the number of shared fields (conflict)
+  size_t shared_num_;
+
+  /// the number of fields in each partition
+  size_t partition_size_;
+
+  /// the highest conflict rate that can be achieved (conflict)
+  double max_conflict_rate_;
+
+  /// the ratio of operations that access shared fields (conflict, capped with one)
+  double shared_op_ratio_;
+
+  /// a sampler of Zipf's law
+  ZipfSamplerType zipf_sampler_;
+
+  /// a random engine according to Zipf's law with a CDF table
+  ZipfGenerator zipf_engine_;
+
+  /// a random engine according to Zipf's law with rejection-inversion
+  RejectionInversionZipf rejection_engine_;
+};
+
+#endif  // MWCAS_BENCHMARK_KEY_DISTRIBUTION_H
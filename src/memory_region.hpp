@@ -0,0 +1,394 @@
+/*
+ * Copyright 2021 Database Group, Nagoya University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MWCAS_BENCHMARK_MEMORY_REGION_H
+#define MWCAS_BENCHMARK_MEMORY_REGION_H
+
+#include <linux/memfd.h>
+#include <linux/mman.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <fstream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common.hpp"
+
+/*##################################################################################################
+ * Global constants and enums
+ *################################################################################################*/
+
+/// the size of a huge page in bytes
+constexpr size_t kHugePageSize = 2UL << 20UL;
+
+/**
+ * @brief Backing modes of memory regions.
+ *
+ */
+enum HugePageMode
+{
+  /// use base pages only
+  kNoHugePage,
+  /// use transparent huge pages via madvise
+  kTHP,
+  /// use pre-reserved pages in hugetlbfs
+  kHugeTLBFS,
+};
+
+/**
+ * @brief A class to manage an anonymous memory region that may be backed by huge pages.
+ *
+ * If hugetlbfs pages cannot be reserved, a region falls back to transparent huge pages. The
+ * actual mode is available via GetMode().
+ */
+class MemoryRegion
+{
+ public:
+  /*################################################################################################
+   * Public constructors and assignment operators
+   *##############################################################################################*/
+
+  /**
+   * @brief Construct a new MemoryRegion object.
+   *
+   * A shared region is backed by a memory file, so its pages are shared with (not copied to)
+   * processes forked after construction at the same virtual address.
+   *
+   * @param size the size of a memory region in bytes.
+   * @param mode a requested backing mode.
+   * @param shared a flag to share a region with forked processes.
+   */
+  MemoryRegion(  //
+      const size_t size,
+      const HugePageMode mode,
+      const bool shared = false)
+      : size_{size}, mode_{mode}
+  {
+    constexpr auto kProt = PROT_READ | PROT_WRITE;
+    constexpr auto kFlags = MAP_PRIVATE | MAP_ANONYMOUS;
+
+    if (mode_ == kHugeTLBFS) {
+      // do not use MAP_NORESERVE here to detect the shortage of huge pages at this point
+      map_size_ = AlignUp(size_, kHugePageSize);
+      if (shared) {
+        const auto fd = CreateSharedFile(map_size_, MFD_HUGETLB | MFD_HUGE_2MB);
+        map_head_ = (fd < 0) ? MAP_FAILED : mmap(nullptr, map_size_, kProt, MAP_SHARED, fd, 0);
+        if (fd >= 0) close(fd);
+      } else {
+        map_head_ = mmap(nullptr, map_size_, kProt, kFlags | MAP_HUGETLB | MAP_HUGE_2MB, -1, 0);
+      }
+      if (map_head_ != MAP_FAILED) {
+        head_ = map_head_;
+        return;
+      }
+      mode_ = kTHP;
+    }
+
+    // reserve an extra huge page to align the head of a region for THP
+    map_size_ = (mode_ == kTHP) ? AlignUp(size_, kHugePageSize) + kHugePageSize : size_;
+    map_head_ = mmap(nullptr, map_size_, kProt, kFlags | MAP_NORESERVE, -1, 0);
+    if (map_head_ == MAP_FAILED) throw std::bad_alloc{};
+
+    head_ = map_head_;
+    if (mode_ == kTHP) {
+      const auto aligned_head = AlignUp(reinterpret_cast<uintptr_t>(map_head_), kHugePageSize);
+      head_ = reinterpret_cast<void *>(aligned_head);
+    }
+    if (shared) {
+      // replace the reserved range with a memory file
+      const auto fd = CreateSharedFile(size_, 0);
+      const auto flags = MAP_SHARED | MAP_FIXED;
+      const auto *mapped = (fd < 0) ? MAP_FAILED : mmap(head_, size_, kProt, flags, fd, 0);
+      if (fd >= 0) close(fd);
+      if (mapped == MAP_FAILED) {
+        munmap(map_head_, map_size_);
+        throw std::bad_alloc{};
+      }
+    }
+    if (mode_ == kTHP) Advise(head_, size_);
+  }
+
+  MemoryRegion(const MemoryRegion &) = delete;
+  MemoryRegion &operator=(const MemoryRegion &obj) = delete;
+  MemoryRegion(MemoryRegion &&) = delete;
+  MemoryRegion &operator=(MemoryRegion &&) = delete;
+
+  /*################################################################################################
+   * Public destructors
+   *##############################################################################################*/
+
+  ~MemoryRegion() { munmap(map_head_, map_size_); }
+
+  /*################################################################################################
+   * Public getters
+   *##############################################################################################*/
+
+  /**
+   * @return the head address of a region.
+   */
+  void *
+  Get() const
+  {
+    return head_;
+  }
+
+  /**
+   * @return the size of a region in bytes.
+   */
+  size_t
+  size() const
+  {
+    return size_;
+  }
+
+  /**
+   * @return the actual backing mode of a region.
+   */
+  HugePageMode
+  GetMode() const
+  {
+    return mode_;
+  }
+
+  /*################################################################################################
+   * Public static utilities
+   *##############################################################################################*/
+
+  /**
+   * @brief Advise an OS to back huge-page-aligned parts of a given range with THP.
+   *
+   * @param addr the head address of a range.
+   * @param size the size of a range in bytes.
+   * @param collapse a flag to synchronously collapse already populated pages if supported.
+   */
+  static void
+  Advise(  //
+      void *addr,
+      const size_t size,
+      [[maybe_unused]] const bool collapse = false)
+  {
+    const auto begin = AlignUp(reinterpret_cast<uintptr_t>(addr), kHugePageSize);
+    const auto end = (reinterpret_cast<uintptr_t>(addr) + size) & ~(kHugePageSize - 1);
+    if (begin >= end) return;
+
+    madvise(reinterpret_cast<void *>(begin), end - begin, MADV_HUGEPAGE);
+#ifdef MADV_COLLAPSE
+    if (collapse) madvise(reinterpret_cast<void *>(begin), end - begin, MADV_COLLAPSE);
+#endif
+  }
+
+  /**
+   * @brief Count the bytes backed by huge pages in a given range.
+   *
+   * This function parses "/proc/self/smaps", so it should not be called in measurement. Since
+   * smaps only reports huge pages per mapping, the count of a mapping that partially overlaps
+   * the range (e.g., a heap that holds operation queues) is scaled by the overlapped fraction.
+   * Thus, the result is exact for ranges that consist of whole mappings, and approximate
+   * otherwise.
+   *
+   * @param addr the head address of a range.
+   * @param size the size of a range in bytes.
+   * @return the (approximate) number of bytes backed by huge pages.
+   */
+  static size_t
+  CountHugePageBytes(  //
+      const void *addr,
+      const size_t size)
+  {
+    const auto begin = reinterpret_cast<uintptr_t>(addr);
+    const auto end = begin + size;
+
+    std::ifstream smaps{"/proc/self/smaps"};
+    std::string line{};
+    double overlap_ratio = 0;
+    double huge_bytes = 0;
+    while (std::getline(smaps, line)) {
+      uintptr_t map_begin, map_end;
+      if (ParseRange(line, map_begin, map_end)) {
+        const auto overlap_begin = std::max(begin, map_begin);
+        const auto overlap_end = std::min(end, map_end);
+        overlap_ratio = (overlap_begin < overlap_end)
+                            ? static_cast<double>(overlap_end - overlap_begin)
+                                  / (map_end - map_begin)
+                            : 0;
+        continue;
+      }
+      if (overlap_ratio == 0) continue;
+
+      std::istringstream in{line};
+      std::string key{};
+      size_t kb = 0;
+      in >> key >> kb;
+      // shared regions (e.g., memfd for worker processes) report THP as shmem/file mappings
+      if (key == "AnonHugePages:" || key == "ShmemPmdMapped:" || key == "FilePmdMapped:"
+          || key == "Private_Hugetlb:" || key == "Shared_Hugetlb:") {
+        huge_bytes += (kb << 10UL) * overlap_ratio;
+      }
+    }
+
+    return std::min(static_cast<size_t>(huge_bytes), size);
+  }
+
+  /**
+   * @brief Get anonymous mappings of this process.
+   *
+   * @return the list of [begin, end) ranges of anonymous mappings.
+   */
+  static std::vector<std::pair<uintptr_t, uintptr_t>>
+  GetAnonymousMappings()
+  {
+    std::vector<std::pair<uintptr_t, uintptr_t>> mappings{};
+
+    std::ifstream maps{"/proc/self/maps"};
+    std::string line{};
+    while (std::getline(maps, line)) {
+      std::istringstream in{line};
+      std::string range{}, perms{}, offset{}, dev{}, inode{}, path{};
+      in >> range >> perms >> offset >> dev >> inode >> path;
+      if (!path.empty()) continue;
+
+      uintptr_t begin, end;
+      if (ParseRange(line, begin, end)) mappings.emplace_back(begin, end);
+    }
+
+    return mappings;
+  }
+
+  /**
+   * @brief Parse a backing mode string.
+   *
+   * @param str a mode string ("none", "thp", or "hugetlbfs").
+   * @param mode a parsed mode.
+   * @retval true if the string is valid.
+   * @retval false otherwise.
+   */
+  static bool
+  Parse(  //
+      const std::string &str,
+      HugePageMode &mode)
+  {
+    if (str == "none") {
+      mode = kNoHugePage;
+    } else if (str == "thp") {
+      mode = kTHP;
+    } else if (str == "hugetlbfs") {
+      mode = kHugeTLBFS;
+    } else {
+      return false;
+    }
+    return true;
+  }
+
+  /**
+   * @param mode a backing mode.
+   * @return the name of the mode.
+   */
+  static std::string
+  ToString(const HugePageMode mode)
+  {
+    switch (mode) {
+      case kTHP:
+        return "thp";
+      case kHugeTLBFS:
+        return "hugetlbfs";
+      case kNoHugePage:
+      default:
+        return "none";
+    }
+  }
+
+ private:
+  /*################################################################################################
+   * Internal utility functions
+   *##############################################################################################*/
+
+  /**
+   * @brief Create an anonymous memory file with a given size.
+   *
+   * @param size the size of a file in bytes.
+   * @param flags additional flags for memfd_create.
+   * @return a file descriptor if succeeded, -1 otherwise.
+   */
+  static int
+  CreateSharedFile(  //
+      const size_t size,
+      const unsigned int flags)
+  {
+    const auto fd = memfd_create("mwcas_bench", MFD_CLOEXEC | flags);
+    if (fd < 0) return -1;
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+      close(fd);
+      return -1;
+    }
+    return fd;
+  }
+
+  static constexpr size_t
+  AlignUp(  //
+      const size_t val,
+      const size_t alignment)
+  {
+    return (val + alignment - 1) & ~(alignment - 1);
+  }
+
+  /**
+   * @brief Parse an address range at the head of a line in "/proc/self/(s)maps".
+   *
+   * @retval true if the line begins with an address range.
+   * @retval false otherwise.
+   */
+  static bool
+  ParseRange(  //
+      const std::string &line,
+      uintptr_t &begin,
+      uintptr_t &end)
+  {
+    const auto hyphen = line.find('-');
+    const auto space = line.find(' ');
+    if (hyphen == std::string::npos || space == std::string::npos || hyphen > space) return false;
+    if (line.find_first_not_of("0123456789abcdef") != hyphen) return false;
+
+    begin = std::stoul(line.substr(0, hyphen), nullptr, 16);
+    end = std::stoul(line.substr(hyphen + 1, space - hyphen - 1), nullptr, 16);
+    return true;
+  }
+
+  /*################################################################################################
+   * Internal member variables
+   *##############################################################################################*/
+
+  /// the size of a region in bytes
+  const size_t size_;
+
+  /// the actual backing mode of a region
+  HugePageMode mode_;
+
+  /// the head address of a region
+  void *head_{nullptr};
+
+  /// the head address of an underlying mapping
+  void *map_head_{nullptr};
+
+  /// the size of an underlying mapping
+  size_t map_size_{0};
+};
+
+#endif  // MWCAS_BENCHMARK_MEMORY_REGION_H
@@ -16,11 +16,23 @@
 
 #include <gflags/gflags.h>
 
+#include <chrono>
+#include <limits>
+#include <memory>
+#include <random>
 #include <string>
+#include <thread>
+#include <vector>
 
+#include "backoff.hpp"
 #include "benchmark/benchmarker.hpp"
 #include "mwcas_target.hpp"
 #include "operation_engine.hpp"
+#include "operation_trace.hpp"
+#include "process_benchmarker.hpp"
+#include "queue_benchmarker.hpp"
+#include "stream_benchmarker.hpp"
+#include "update_function.hpp"
 
 /*##################################################################################################
  * CLI validators
@@ -48,6 +60,17 @@ ValidateNonZero(const char *flagname, const Number value)
   return false;
 }
 
+template <class Number>
+static bool
+ValidateWordAligned(const char *flagname, const Number value)
+{
+  if (value % sizeof(uint64_t) == 0) {
+    return true;
+  }
+  std::cout << "A value must be a multiple of 8 for " << flagname << std::endl;
+  return false;
+}
+
 static bool
 ValidateRandomSeed([[maybe_unused]] const char *flagname, const std::string &seed)
 {
@@ -64,22 +87,259 @@ ValidateRandomSeed([[maybe_unused]] const char *flagname, const std::string &see
   return true;
 }
 
+static bool
+ValidateFieldStride(const char *flagname, const uint64_t stride)
+{
+  if (stride == kDenseStride || stride == kCacheLineStride || stride == kLinePairStride) {
+    return true;
+  }
+  std::cout << "A value must be 8, 64, or 128 for " << flagname << std::endl;
+  return false;
+}
+
+static bool
+ValidateNUMAPolicy([[maybe_unused]] const char *flagname, const std::string &policy_str)
+{
+  NUMAPolicy policy;
+  int node;
+  if (NUMAPlacement::Parse(policy_str, policy, node)) {
+    return true;
+  }
+  std::cout << "A NUMA policy must be default, local, interleave, bind:<node> (an available "
+            << "node up to " << NUMAPlacement::GetMaxNode() << "), or first_touch" << std::endl;
+  return false;
+}
+
+static bool
+ValidateHugePageMode([[maybe_unused]] const char *flagname, const std::string &mode_str)
+{
+  HugePageMode mode;
+  if (MemoryRegion::Parse(mode_str, mode)) {
+    return true;
+  }
+  std::cout << "A huge page mode must be none, thp, or hugetlbfs" << std::endl;
+  return false;
+}
+
+template <class Number>
+static bool
+ValidateRatio(const char *flagname, const Number value)
+{
+  if (value >= 0 && value <= 1) {
+    return true;
+  }
+  std::cout << "A value must be in [0, 1] for " << flagname << std::endl;
+  return false;
+}
+
+template <class Number>
+static bool
+ValidateStrictlyPositive(const char *flagname, const Number value)
+{
+  if (value > 0) {
+    return true;
+  }
+  std::cout << "A value must be larger than zero for " << flagname << std::endl;
+  return false;
+}
+
+static bool
+ValidateKeyDist([[maybe_unused]] const char *flagname, const std::string &dist_str)
+{
+  KeyDistType dist_type;
+  if (KeyDistribution::Parse(dist_str, dist_type)) {
+    return true;
+  }
+  std::cout << "A key distribution must be zipf, uniform, hotspot, moving_hotspot, exponential, "
+               "partitioned, or conflict"
+            << std::endl;
+  return false;
+}
+
+static bool
+ValidateZipfSampler([[maybe_unused]] const char *flagname, const std::string &sampler_str)
+{
+  ZipfSamplerType sampler;
+  if (KeyDistribution::Parse(sampler_str, sampler)) {
+    return true;
+  }
+  std::cout << "A Zipf sampler must be table or rejection_inversion" << std::endl;
+  return false;
+}
+
+static bool
+ValidateBackoff([[maybe_unused]] const char *flagname, const std::string &policy_str)
+{
+  BackoffPolicy policy;
+  if (Backoff::Parse(policy_str, policy)) {
+    return true;
+  }
+  std::cout << "A backoff policy must be none, exponential, randomized, yield, or adaptive"
+            << std::endl;
+  return false;
+}
+
+static bool
+ValidateUpdateKind([[maybe_unused]] const char *flagname, const std::string &kind_str)
+{
+  UpdateKind kind;
+  if (UpdateFunction::Parse(kind_str, kind)) {
+    return true;
+  }
+  std::cout << "An update kind must be increment, pointer_swap, version_bump, or conditional"
+            << std::endl;
+  return false;
+}
+
+static bool
+ValidateWidthDist([[maybe_unused]] const char *flagname, const std::string &dist_str)
+{
+  WidthDistribution::Weights_t weights;
+  if (WidthDistribution::Parse(dist_str, weights)) {
+    return true;
+  }
+  std::cout << "A width distribution must be weighted widths up to " << kTargetNum
+            << " (e.g., 1:70,2:30)" << std::endl;
+  return false;
+}
+
+static bool
+ValidateKeyLayout([[maybe_unused]] const char *flagname, const std::string &layout_str)
+{
+  KeyLayout layout;
+  if (OperationEngine::Parse(layout_str, layout)) {
+    return true;
+  }
+  std::cout << "A key layout must be clustered, scattered, or page_spread" << std::endl;
+  return false;
+}
+
 /*##################################################################################################
  * CLI arguments
  *################################################################################################*/
 
 DEFINE_uint64(num_field, 1000000, "The total number of target fields");
 DEFINE_validator(num_field, &ValidateNonZero);
+DEFINE_uint64(field_stride, kDenseStride,
+              "The distance between adjacent target fields in bytes (8: dense, 64: one field per "
+              "cache line, 128: one field per adjacent-line pair)");
+DEFINE_validator(field_stride, &ValidateFieldStride);
+DEFINE_uint64(record_size, 0,
+              "The size of records that embed target fields in bytes (0: use --field_stride)");
+DEFINE_validator(record_size, &ValidateWordAligned);
+DEFINE_uint64(word_offset, 0, "The offset of a target field in each record in bytes");
+DEFINE_validator(word_offset, &ValidateWordAligned);
+DEFINE_uint64(payload_touch_bytes, 0,
+              "The number of payload bytes after each target field touched by an operation");
+DEFINE_validator(payload_touch_bytes, &ValidateWordAligned);
+DEFINE_bool(write_payload, false, "true: write payloads, false: read payloads");
 DEFINE_uint64(num_exec, 10000000, "The total number of MwCAS operations");
 DEFINE_validator(num_exec, &ValidateNonZero);
 DEFINE_uint64(num_thread, 8, "The number of worker threads for benchmarking");
 DEFINE_validator(num_thread, &ValidateNonZero);
 DEFINE_double(skew_parameter, 0, "A skew parameter (based on Zipf's law)");
 DEFINE_validator(skew_parameter, &ValidatePositiveVal);
+DEFINE_string(key_dist, "zipf",
+              "A distribution to select target fields (zipf, uniform, hotspot, moving_hotspot, "
+              "exponential, partitioned: Zipf's law in per-worker partitions without "
+              "conflicts, or conflict: a shared set and per-worker private sets)");
+DEFINE_validator(key_dist, &ValidateKeyDist);
+DEFINE_string(zipf_sampler, "table",
+              "A sampler of Zipf's law (table: a CDF table with O(n) memory and setup time, "
+              "rejection_inversion: O(1) memory and time per sample for huge numbers of fields)");
+DEFINE_validator(zipf_sampler, &ValidateZipfSampler);
+DEFINE_double(hot_op_ratio, 0.8, "The ratio of operations that access hot fields (hotspots)");
+DEFINE_validator(hot_op_ratio, &ValidateRatio);
+DEFINE_double(hot_field_ratio, 0.2, "The ratio of hot fields in all the fields (hotspots)");
+DEFINE_validator(hot_field_ratio, &ValidateRatio);
+DEFINE_uint64(hotspot_period, 100000,
+              "The number of operations per worker before a moving hotspot shifts to next fields");
+DEFINE_validator(hotspot_period, &ValidateNonZero);
+DEFINE_double(exp_lambda, 10.0,
+              "The rate of an exponential distribution over ranks normalized into [0, 1)");
+DEFINE_validator(exp_lambda, &ValidateStrictlyPositive);
+DEFINE_double(conflict_rate, 0.1,
+              "The requested probability that two operations of different workers share any "
+              "target field (conflict)");
+DEFINE_validator(conflict_rate, &ValidateRatio);
+DEFINE_uint64(shared_field_num, kTargetNum,
+              "The number of target fields shared by workers (conflict)");
+DEFINE_validator(shared_field_num, &ValidateNonZero);
+DEFINE_double(read_ratio, 0,
+              "The ratio of read-only operations that read target words with MwCAS-aware "
+              "procedures");
+DEFINE_validator(read_ratio, &ValidateRatio);
+DEFINE_string(update_kind, "increment",
+              "New values installed by MwCAS (increment, pointer_swap: rotate values among "
+              "targets, version_bump: bump the tags of tagged pointers, or conditional: increment "
+              "only if the first target is even)");
+DEFINE_validator(update_kind, &ValidateUpdateKind);
+DEFINE_bool(presort, true,
+            "true: sort targets in generation, false: sort them in the measured path of each "
+            "update");
+DEFINE_string(backoff, "none",
+              "A contention-management policy between failed MwCAS attempts (none, exponential, "
+              "randomized: exponential with random periods, yield: sched_yield, or adaptive: "
+              "randomized with per-thread windows adapted to recent contention)");
+DEFINE_validator(backoff, &ValidateBackoff);
+DEFINE_uint64(think_cycles, 0,
+              "The number of TSC cycles of computation between reading old values and MwCAS");
+DEFINE_string(width_dist, "",
+              "Weighted numbers of target words of operations (e.g., 1:70,2:20,3:10), where the "
+              "default uses all the compiled target words");
+DEFINE_validator(width_dist, &ValidateWidthDist);
+DEFINE_string(key_layout, "clustered",
+              "A mapping from the ranks of a key distribution to target fields (clustered: "
+              "allocation order, scattered: a random permutation, page_spread: consecutive "
+              "ranks in different pages)");
+DEFINE_validator(key_layout, &ValidateKeyLayout);
 DEFINE_uint64(num_init_thread, 8, "The number of worker threads for initialization");
 DEFINE_validator(num_init_thread, &ValidateNonZero);
+DEFINE_string(field_numa_policy, "default",
+              "A NUMA placement policy of target fields (default: leave it to an OS, local: the "
+              "node of a main thread, interleave: all the nodes, bind:<node>: a specified node, "
+              "first_touch: the node of each worker that owns a partition of fields)");
+DEFINE_validator(field_numa_policy, &ValidateNUMAPolicy);
+DEFINE_string(huge_pages, "none",
+              "Back target fields, operation queues, and the PMwCAS descriptor pool with 2MB pages "
+              "(none, thp, or hugetlbfs)");
+DEFINE_validator(huge_pages, &ValidateHugePageMode);
+DEFINE_bool(pin_workers, false,
+            "Pin worker threads to CPUs in node-major order (always true for first_touch)");
+DEFINE_bool(numa_stats, false, "Report per-node throughput and remote-access ratios");
+DEFINE_bool(abort_stats, false,
+            "Report the ratio of failed MwCAS attempts (always true for --key_dist=conflict)");
+DEFINE_bool(op_stats, false,
+            "Report throughput and average latency of each MwCAS width and operation type (this "
+            "adds two clock reads to each measured operation)");
+DEFINE_bool(descriptor_stats, false,
+            "Report how often reads and commits find in-progress MwCAS descriptors in target "
+            "words");
+DEFINE_bool(timing_stats, false,
+            "Report wall-clock time of each benchmark phase (e.g., field init, op queue setup, "
+            "and measurement) and the footprints of operation queues and traces");
+DEFINE_uint64(phase_sample, 0,
+              "Report a breakdown of update cycles into phases by measuring every N-th update of "
+              "each worker with rdtsc (0: disabled)");
+DEFINE_uint64(prefetch_distance, 0,
+              "Prefetch the target words of the N-th next operation while executing each one "
+              "(0: disabled; only for throughput)");
+DEFINE_uint64(num_warmup, 0, "The total number of MwCAS operations for warming up");
 DEFINE_string(seed, "", "A random seed to control reproducibility");
 DEFINE_validator(seed, &ValidateRandomSeed);
+DEFINE_bool(multi_process, false,
+            "Run workers as forked processes over target fields in shared memory (only for our "
+            "MwCAS and Single CAS, so --pmwcas=false and --aopt=false are required; only for "
+            "throughput)");
+DEFINE_bool(stream_ops, false,
+            "Generate operations on the fly in small batches in each worker instead of replaying "
+            "pre-generated operation queues (only for throughput)");
+DEFINE_string(dump_trace, "",
+              "Write operations generated with the other options to a binary trace file in "
+              "per-worker partitions and exit without measurement");
+DEFINE_string(trace_file, "",
+              "Replay operations in a binary trace file, which also determines the numbers of "
+              "target fields and operations (only for throughput with threads)");
 DEFINE_bool(csv, false, "Output benchmark results as CSV format");
 DEFINE_bool(throughput, true, "true: measure throughput, false: measure latency");
 DEFINE_bool(mwcas, true, "Use our MwCAS library as a benchmark target");
@@ -91,30 +351,390 @@ DEFINE_bool(single, false, "Use Single CAS as a benchmark target");
  * Utility functions
  *################################################################################################*/
 
-template <class Implementation>
+/**
+ * @return the distance between adjacent target fields in bytes.
+ */
+static size_t
+GetFieldStride()
+{
+  return (FLAGS_record_size > 0) ? FLAGS_record_size : FLAGS_field_stride;
+}
+
+/**
+ * @retval true if a target field and its touched payload fit in a record.
+ * @retval false otherwise.
+ */
+static bool
+ValidateRecordLayout()
+{
+  if (FLAGS_word_offset + sizeof(uint64_t) + FLAGS_payload_touch_bytes <= GetFieldStride()) {
+    return true;
+  }
+  std::cout << "A target field and its touched payload must fit in a record" << std::endl;
+  return false;
+}
+
+/**
+ * @retval true if there are enough target fields for one operation and every target field can
+ * be referred by workloads in index form.
+ * @retval false otherwise.
+ */
+static bool
+ValidateFieldNum()
+{
+  constexpr auto kIsCompact = std::is_same_v<QueuedOperation, CompactOperation>;
+  constexpr uint64_t kMaxFieldNum = std::numeric_limits<CompactOperation::Index_t>::max() + 1UL;
+  if (FLAGS_num_field < kTargetNum) {
+    std::cout << "Target fields must be at least " << kTargetNum << std::endl;
+    return false;
+  }
+  if ((kIsCompact || !FLAGS_stream_ops) && FLAGS_num_field > kMaxFieldNum) {
+    std::cout << "Operation queues and traces can refer at most " << kMaxFieldNum
+              << " target fields" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+/**
+ * @retval true if every worker has enough fields in its partition.
+ * @retval false otherwise.
+ */
+static bool
+ValidatePartitions()
+{
+  size_t shared_num = 0;
+  if (FLAGS_key_dist == "conflict") {
+    shared_num = FLAGS_shared_field_num;
+    if (shared_num < kTargetNum || shared_num >= FLAGS_num_field) {
+      std::cout << "Shared fields must be at least " << kTargetNum << " and less than all the "
+                << "fields" << std::endl;
+      return false;
+    }
+  } else if (FLAGS_key_dist != "partitioned") {
+    return true;
+  }
+
+  if ((FLAGS_num_field - shared_num) / FLAGS_num_thread >= kTargetNum) {
+    return true;
+  }
+  std::cout << "Each worker must have at least " << kTargetNum << " fields in its partition"
+            << std::endl;
+  return false;
+}
+
+/**
+ * @return a distribution of widths given by command line options.
+ */
+static WidthDistribution
+CreateWidthDistribution()
+{
+  WidthDistribution::Weights_t width_weights{};
+  WidthDistribution::Parse(FLAGS_width_dist, width_weights);
+  return WidthDistribution{width_weights};
+}
+
+/**
+ * @return a key distribution given by command line options.
+ */
+static KeyDistribution
+CreateKeyDistribution()
+{
+  KeyDistType key_dist_type = kZipf;
+  KeyDistribution::Parse(FLAGS_key_dist, key_dist_type);
+  ZipfSamplerType zipf_sampler = kZipfTable;
+  KeyDistribution::Parse(FLAGS_zipf_sampler, zipf_sampler);
+  return KeyDistribution{key_dist_type,          FLAGS_num_field,       FLAGS_skew_parameter,
+                         FLAGS_hot_op_ratio,     FLAGS_hot_field_ratio, FLAGS_hotspot_period,
+                         FLAGS_exp_lambda,       FLAGS_num_thread,      FLAGS_conflict_rate,
+                         FLAGS_shared_field_num, zipf_sampler,          CreateWidthDistribution()};
+}
+
+/**
+ * @retval true if a requested conflict rate can be achieved with shared fields and widths.
+ * @retval false otherwise.
+ */
+static bool
+ValidateConflictRate()
+{
+  if (FLAGS_key_dist != "conflict" || !FLAGS_trace_file.empty()) return true;
+
+  const auto max_rate = CreateKeyDistribution().GetMaxConflictRate();
+  if (FLAGS_conflict_rate <= max_rate) return true;
+  std::cout << "A conflict rate must be at most " << max_rate << " with "
+            << FLAGS_shared_field_num << " shared fields and the given widths (decrease "
+            << "--shared_field_num or use wider operations)" << std::endl;
+  return false;
+}
+
+/**
+ * @return a random seed given by command line options (or a random one).
+ */
+static size_t
+GetRandomSeed()
+{
+  return (FLAGS_seed.empty()) ? std::random_device{}() : std::stoul(FLAGS_seed);
+}
+
+/**
+ * @param start_time the time when a phase started.
+ * @return elapsed time from the start in seconds.
+ */
+static double
+GetElapsedSec(const std::chrono::high_resolution_clock::time_point &start_time)
+{
+  const auto elapsed = std::chrono::high_resolution_clock::now() - start_time;
+  return std::chrono::duration<double>(elapsed).count();
+}
+
+/**
+ * @brief Add the wall-clock time (or a footprint) of a benchmark phase if requested.
+ *
+ * @tparam T the type of a value.
+ * @param report a report to add a row to.
+ * @param key the name of a value.
+ * @param value a value to be output.
+ */
+template <class T>
+static void
+AddPhase(  //
+    Report &report,
+    const std::string &key,
+    const T &value)
+{
+  if (FLAGS_timing_stats) report.Add("phase", key, value);
+}
+
+/**
+ * @brief Execute operations for warming up with the same number of threads as workers.
+ *
+ * @param target a benchmark target.
+ * @param ops_engine an engine to generate operations.
+ * @param placement placement of worker threads.
+ * @param random_seed a base random seed.
+ */
+template <class MwCASTarget_t>
+static void
+WarmUp(  //
+    MwCASTarget_t &target,
+    OperationEngine &ops_engine,
+    const NUMAPlacement &placement,
+    const size_t random_seed)
+{
+  // use a different seed sequence from measurement
+  std::mt19937_64 rand_engine{~random_seed};
+
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < FLAGS_num_thread; ++i) {
+    const size_t n = (FLAGS_num_warmup + i) / FLAGS_num_thread;
+    threads.emplace_back([&, i, n, seed = rand_engine()] {
+      if (placement.PinWorkers()) placement.PinThread(i);
+      const auto operations = ops_engine.Generate(n, seed, i);
+      target.ExecuteBatch(operations.data(), operations.size());
+    });
+  }
+  for (auto &&t : threads) t.join();
+
+  target.ResetWorkers();
+  ops_engine.ResetStats();
+}
+
+template <class Implementation, class Layout>
 void
-RunBenchmark(const std::string &target_name)
+RunBenchmark(  //
+    const std::string &target_name,
+    const size_t random_seed,
+    const OperationTrace *trace,
+    const OperationEngine::Workload_t *workload)
 {
-  using MwCASTarget_t = MwCASTarget<Implementation>;
-  using Bench_t = ::dbgroup::benchmark::Benchmarker<MwCASTarget_t, Operation, OperationEngine>;
+  using MwCASTarget_t = MwCASTarget<Implementation, Layout>;
+  using Bench_t =
+      ::dbgroup::benchmark::Benchmarker<MwCASTarget_t, QueuedOperation, OperationEngine>;
+  using Clock_t = ::std::chrono::high_resolution_clock;
 
   if constexpr (std::is_same_v<Implementation, AOPT>) {
     AOPT::StartGC(100000, 4);
   }
 
-  MwCASTarget_t target{FLAGS_num_field, FLAGS_num_init_thread, FLAGS_num_thread};
-  OperationEngine ops_engine{target.ReferTargetFields(), FLAGS_skew_parameter};
-  const auto random_seed = (FLAGS_seed.empty()) ? std::random_device{}() : std::stoul(FLAGS_seed);
+  NUMAPolicy numa_policy = kDefaultPolicy;
+  int numa_node = 0;
+  NUMAPlacement::Parse(FLAGS_field_numa_policy, numa_policy, numa_node);
+  const NUMAPlacement placement{numa_policy, numa_node, FLAGS_pin_workers};
+
+  HugePageMode huge_page_mode = kNoHugePage;
+  MemoryRegion::Parse(FLAGS_huge_pages, huge_page_mode);
+
+  Report report{FLAGS_csv};
+  const Layout layout{FLAGS_payload_touch_bytes, FLAGS_write_payload};
+  UpdateKind update_kind = kIncrement;
+  UpdateFunction::Parse(FLAGS_update_kind, update_kind);
+  const UpdateFunction update{update_kind, FLAGS_think_cycles};
+  BackoffPolicy backoff = kNoBackoff;
+  Backoff::Parse(FLAGS_backoff, backoff);
+  const auto width_dist = CreateWidthDistribution();
 
-  Bench_t bench{target,      ops_engine,       FLAGS_num_exec, FLAGS_num_thread,
-                random_seed, FLAGS_throughput, FLAGS_csv,      target_name};
-  bench.Run();
+  auto start_time = Clock_t::now();
+  auto target = std::make_unique<MwCASTarget_t>(
+      FLAGS_num_field, GetFieldStride(), FLAGS_word_offset, layout, update, FLAGS_presort, backoff,
+      huge_page_mode, placement, FLAGS_numa_stats,
+      FLAGS_abort_stats || FLAGS_key_dist == "conflict", FLAGS_descriptor_stats, FLAGS_op_stats,
+      FLAGS_phase_sample, FLAGS_prefetch_distance, FLAGS_multi_process, FLAGS_num_init_thread,
+      FLAGS_num_thread);
+  AddPhase(report, "field init [s]", GetElapsedSec(start_time));
+
+  const auto key_dist = CreateKeyDistribution();
+  KeyLayout key_layout = kClustered;
+  OperationEngine::Parse(FLAGS_key_layout, key_layout);
+  OperationEngine ops_engine{target->ReferTargetFields(),
+                             key_dist,
+                             width_dist,
+                             FLAGS_read_ratio,
+                             key_layout,
+                             random_seed,
+                             huge_page_mode,
+                             placement,
+                             FLAGS_presort};
+
+  start_time = Clock_t::now();
+  if (FLAGS_num_warmup > 0) WarmUp(*target, ops_engine, placement, random_seed);
+  AddPhase(report, "warm-up [s]", GetElapsedSec(start_time));
+  ops_engine.SetWorkload(workload);
+
+  // the benchmarkers prepare operation queues before measurement unless streaming them
+  start_time = Clock_t::now();
+  if (trace != nullptr) {
+    TraceReplayer replayer{*trace, target->ReferTargetFields(), FLAGS_num_thread, FLAGS_presort};
+    StreamBenchmarker<MwCASTarget_t, TraceReplayer> bench{
+        *target,     replayer,  placement,  FLAGS_num_exec, FLAGS_num_thread,
+        random_seed, FLAGS_csv, target_name};
+    bench.Run();
+    AddPhase(report, "measurement (with trace decoding) [s]", GetElapsedSec(start_time));
+    AddPhase(report, "trace file [MiB]", trace->size() / static_cast<double>(1UL << 20UL));
+  } else if (FLAGS_stream_ops) {
+    StreamBenchmarker<MwCASTarget_t> bench{*target,          ops_engine,       placement,
+                                           FLAGS_num_exec,   FLAGS_num_thread, random_seed,
+                                           FLAGS_csv,        target_name};
+    bench.Run();
+    AddPhase(report, "measurement (with op generation) [s]", GetElapsedSec(start_time));
+  } else if (FLAGS_multi_process) {
+    ProcessBenchmarker<MwCASTarget_t> bench{*target,          ops_engine,       placement,
+                                            FLAGS_num_exec,   FLAGS_num_thread, random_seed,
+                                            FLAGS_csv,        target_name};
+    bench.Run();
+    const auto run_sec = GetElapsedSec(start_time);
+    AddPhase(report, "op queue setup [s]", bench.GetGenerationTime());
+    AddPhase(report, "measurement [s]", run_sec - bench.GetGenerationTime());
+  } else if (FLAGS_prefetch_distance > 0) {
+    // replay whole queues in batches so that the target can prefetch later operations
+    QueueBenchmarker<MwCASTarget_t> bench{*target,          ops_engine,       placement,
+                                          FLAGS_num_exec,   FLAGS_num_thread, random_seed,
+                                          FLAGS_csv,        target_name};
+    bench.Run();
+    const auto run_sec = GetElapsedSec(start_time);
+    AddPhase(report, "op queue setup [s]", ops_engine.GetGenerationTime());
+    AddPhase(report, "op queue setup (total CPU) [s]", ops_engine.GetTotalGenerationTime());
+    AddPhase(report, "measurement [s]", run_sec - ops_engine.GetGenerationTime());
+    AddPhase(report, "operation queues [MiB]",
+             FLAGS_num_exec * sizeof(QueuedOperation) / static_cast<double>(1UL << 20UL));
+  } else {
+    Bench_t bench{*target,     ops_engine,       FLAGS_num_exec, FLAGS_num_thread,
+                  random_seed, FLAGS_throughput, FLAGS_csv,      target_name};
+    bench.Run();
+    const auto run_sec = GetElapsedSec(start_time);
+    AddPhase(report, "op queue setup [s]", ops_engine.GetGenerationTime());
+    AddPhase(report, "op queue setup (total CPU) [s]", ops_engine.GetTotalGenerationTime());
+    AddPhase(report, "measurement [s]", run_sec - ops_engine.GetGenerationTime());
+    AddPhase(report, "operation queues [MiB]",
+             FLAGS_num_exec * sizeof(QueuedOperation) / static_cast<double>(1UL << 20UL));
+  }
+
+  target->ReportHugePages(report);
+  ops_engine.ReportHugePages(report);
+  target->ReportNUMAStats(report);
+  if (trace == nullptr && FLAGS_key_dist == "conflict") {
+    report.Add("conflicts", "requested conflict rate", FLAGS_conflict_rate);
+    report.Add("conflicts", "shared operation ratio", key_dist.GetSharedOpRatio());
+  }
+  target->ReportAbortStats(report);
+  target->ReportDescriptorStats(report);
+  target->ReportOperationStats(report);
+  target->ReportPhaseStats(report);
+
+  start_time = Clock_t::now();
+  target.reset(nullptr);
+  AddPhase(report, "teardown [s]", GetElapsedSec(start_time));
+  report.Output();
 
   if constexpr (std::is_same_v<Implementation, AOPT>) {
     AOPT::StopGC();
   }
 }
 
+template <class Implementation>
+void
+RunBenchmark(  //
+    const std::string &target_name,
+    const size_t random_seed,
+    const OperationTrace *trace,
+    const OperationEngine::Workload_t *workload)
+{
+  if (FLAGS_payload_touch_bytes > 0) {
+    RunBenchmark<Implementation, RecordLayout>(target_name, random_seed, trace, workload);
+  } else {
+    RunBenchmark<Implementation, WordLayout>(target_name, random_seed, trace, workload);
+  }
+}
+
+/**
+ * @brief Generate per-worker operation queues in index form with command line options.
+ *
+ * @param random_seed a base random seed.
+ * @param presort a flag to sort the targets of each operation.
+ * @return generated queues.
+ */
+static OperationEngine::Workload_t
+GenerateWorkload(  //
+    const size_t random_seed,
+    const bool presort)
+{
+  HugePageMode huge_page_mode = kNoHugePage;
+  MemoryRegion::Parse(FLAGS_huge_pages, huge_page_mode);
+  KeyLayout key_layout = kClustered;
+  OperationEngine::Parse(FLAGS_key_layout, key_layout);
+
+  // fields are never touched, but they determine page-spread layouts
+  const TargetFields fields{FLAGS_num_field, GetFieldStride(), FLAGS_word_offset, huge_page_mode};
+  const NUMAPlacement placement{kDefaultPolicy, 0, false};
+  OperationEngine ops_engine{fields,
+                             CreateKeyDistribution(),
+                             CreateWidthDistribution(),
+                             FLAGS_read_ratio,
+                             key_layout,
+                             random_seed,
+                             huge_page_mode,
+                             placement,
+                             presort};
+  return ops_engine.GenerateWorkload(FLAGS_num_exec, FLAGS_num_thread, random_seed);
+}
+
+/**
+ * @brief Write operations generated with command line options to a trace file.
+ *
+ * @param random_seed a base random seed.
+ * @retval true if a trace file has been written.
+ * @retval false otherwise.
+ */
+static bool
+DumpTrace(const size_t random_seed)
+{
+  // the trace format requires sorted targets
+  const auto &workload = GenerateWorkload(random_seed, true);
+  if (OperationTrace::Write(FLAGS_dump_trace, FLAGS_num_field, workload)) return true;
+
+  std::cout << "Cannot write a trace to " << FLAGS_dump_trace << std::endl;
+  return false;
+}
+
 /*##################################################################################################
  * Main function
  *################################################################################################*/
@@ -125,12 +745,68 @@ main(int argc, char *argv[])
   // parse command line options
   gflags::SetUsageMessage("measures throughput/latency of MwCAS implementations.");
   gflags::ParseCommandLineFlags(&argc, &argv, false);
+  std::unique_ptr<OperationTrace> trace{};
+  if (!FLAGS_trace_file.empty()) {
+    trace = std::make_unique<OperationTrace>(FLAGS_trace_file);
+    if (!trace->IsValid()) {
+      std::cout << "Invalid trace: " << trace->GetError() << std::endl;
+      return 1;
+    }
+    // a trace determines target fields and operations
+    FLAGS_num_field = trace->GetFieldNum();
+    FLAGS_num_exec = trace->GetOpNum();
+  }
+  if (!ValidateRecordLayout() || !ValidateFieldNum() || !ValidatePartitions()
+      || !ValidateConflictRate()) {
+    return 1;
+  }
+  if (FLAGS_multi_process && !FLAGS_throughput) {
+    std::cout << "Worker processes can be used only for measuring throughput" << std::endl;
+    return 1;
+  }
+  if (FLAGS_multi_process && (FLAGS_pmwcas || FLAGS_aopt)) {
+    // their descriptors and epochs are allocated in process-local memory by the libraries
+    std::cout << "Worker processes can be used only for our MwCAS and Single CAS (specify "
+                 "--pmwcas=false and --aopt=false)"
+              << std::endl;
+    return 1;
+  }
+  if ((FLAGS_stream_ops || !FLAGS_trace_file.empty())
+      && (FLAGS_multi_process || !FLAGS_throughput)) {
+    std::cout << "Streaming operations can be used only for measuring throughput with threads"
+              << std::endl;
+    return 1;
+  }
+
+  if (FLAGS_prefetch_distance > 0 && !FLAGS_throughput) {
+    std::cout << "Prefetching can be used only for measuring throughput" << std::endl;
+    return 1;
+  }
+
+  // every implementation uses the same seed (and so the same workload)
+  const auto random_seed = GetRandomSeed();
+  if (!FLAGS_dump_trace.empty()) return DumpTrace(random_seed) ? 0 : 1;
+
+  // generate queues once in index form, and each implementation restores them for its fields
+  OperationEngine::Workload_t workload{};
+  Report report{FLAGS_csv};
+  if (trace == nullptr && !FLAGS_stream_ops) {
+    const auto start_time = std::chrono::high_resolution_clock::now();
+    workload = GenerateWorkload(random_seed, FLAGS_presort);
+    AddPhase(report, "workload generation [s]", GetElapsedSec(start_time));
+    AddPhase(report, "workload [MiB]",
+             FLAGS_num_exec * sizeof(CompactOperation) / static_cast<double>(1UL << 20UL));
+  }
+  const auto *workload_ptr = workload.empty() ? nullptr : &workload;
 
   // run benchmark for each implementaton
-  if (FLAGS_mwcas) RunBenchmark<MwCAS>("MwCAS without GC");
-  if (FLAGS_pmwcas) RunBenchmark<PMwCAS>("PMwCAS");
-  if (FLAGS_aopt) RunBenchmark<AOPT>("AOPT");
-  if (FLAGS_single) RunBenchmark<SingleCAS>("Single CAS");
+  if (FLAGS_mwcas) RunBenchmark<MwCAS>("MwCAS without GC", random_seed, trace.get(), workload_ptr);
+  if (FLAGS_pmwcas) RunBenchmark<PMwCAS>("PMwCAS", random_seed, trace.get(), workload_ptr);
+  if (FLAGS_aopt) RunBenchmark<AOPT>("AOPT", random_seed, trace.get(), workload_ptr);
+  if (FLAGS_single) RunBenchmark<SingleCAS>("Single CAS", random_seed, trace.get(), workload_ptr);
+
+  // output shared setup costs after results so that a result is the first line of CSV output
+  report.Output();
 
   return 0;
 }
@@ -17,25 +17,99 @@
 #ifndef MWCAS_BENCHMARK_MWCAS_TARGET_H
 #define MWCAS_BENCHMARK_MWCAS_TARGET_H
 
+#include <algorithm>
+#include <array>
+#include <chrono>
 #include <memory>
+#include <string>
 #include <thread>
+#include <utility>
 #include <vector>
 
+#include "backoff.hpp"
 #include "common.hpp"
+#include "descriptor_probe.hpp"
+#include "memory_region.hpp"
+#include "numa_placement.hpp"
 #include "operation.hpp"
+#include "phase_timer.hpp"
 #include "pmwcas.h"
+#include "record_layout.hpp"
+#include "report.hpp"
+#include "target_fields.hpp"
+#include "update_function.hpp"
+
+/// the number of PMwCAS descriptors in the pool for each worker
+constexpr size_t kPMwCASDescPerWorker = 8192;
 
 // declare PMwCAS's descriptor pool globally in order to define a templated worker class
 inline std::unique_ptr<PMwCAS> pmwcas_desc_pool = nullptr;
 
+// a slot of our MwCAS descriptor in a shared memory region (only set in forked workers)
+inline MwCAS *shared_mwcas_desc = nullptr;
+
 /**
- * @brief A class to deal with MwCAS target data and algorthms.
+ * @brief A class to perform MwCAS operations by using a certain implementation.
  *
  * @tparam Implementation A certain implementation of MwCAS algorithms.
  */
 template <class Implementation>
+class MwCASProcedure
+{
+ public:
+  /**
+   * @brief Perform an MwCAS operation until it succeeds.
+   *
+   * @tparam Backoff a contention-management policy between failed attempts.
+   * @tparam Timer a timer to attribute cycles to the phases of an operation.
+   * @param ops target addresses of an MwCAS operation.
+   * @param update a function to compute new values after think time.
+   * @param timer a started timer.
+   * @param probe a probe to count descriptors in target words (nullptr if not counted).
+   * @return the number of failed attempts (i.e., aborts due to conflicts).
+   */
+  template <class Backoff, class Timer>
+  static size_t Execute(  //
+      const Operation &ops,
+      const UpdateFunction &update,
+      Timer &timer,
+      DescriptorProbe *probe);
+
+  /**
+   * @brief Read target words with a procedure aware of in-progress MwCAS operations.
+   *
+   * @param ops target addresses of a read operation.
+   * @param probe a probe to count descriptors in target words (nullptr if not counted).
+   */
+  static void Read(  //
+      const Operation &ops,
+      DescriptorProbe *probe);
+
+  /**
+   * @return the size of a descriptor for one MwCAS operation in bytes.
+   */
+  static constexpr size_t GetDescriptorSize();
+
+ private:
+  /// a sink to prevent reads from being optimized away
+  static inline thread_local volatile size_t sink_{0};
+};
+
+/**
+ * @brief A class to deal with MwCAS target data and algorthms.
+ *
+ * @tparam Implementation A certain implementation of MwCAS algorithms.
+ * @tparam Layout A layout of records that embed target words.
+ */
+template <class Implementation, class Layout = WordLayout>
 class MwCASTarget
 {
+  /*################################################################################################
+   * Type aliases
+   *##############################################################################################*/
+
+  using Clock_t = ::std::chrono::high_resolution_clock;
+
  public:
   /*################################################################################################
    * Public constructors/destructors
@@ -43,32 +117,76 @@ class MwCASTarget
 
   MwCASTarget(  //
       const size_t total_field_num,
+      const size_t field_stride,
+      const size_t word_offset,
+      const Layout &layout,
+      const UpdateFunction &update,
+      const bool presort,
+      const BackoffPolicy backoff,
+      const HugePageMode huge_page_mode,
+      const NUMAPlacement &placement,
+      const bool numa_stats,
+      const bool abort_stats,
+      const bool descriptor_stats,
+      const bool op_stats,
+      const size_t phase_sample,
+      const size_t prefetch_distance,
+      const bool process_shared,
       const size_t init_thread_num,
       const size_t worker_num)
-      : target_fields_{total_field_num, nullptr}
+      : target_fields_{total_field_num, field_stride, word_offset, huge_page_mode, process_shared},
+        layout_{layout},
+        update_{update},
+        presort_{presort},
+        backoff_{backoff},
+        huge_page_mode_{huge_page_mode},
+        placement_{placement},
+        numa_stats_{numa_stats},
+        abort_stats_{kRetryStats && abort_stats},
+        descriptor_stats_{!process_shared && descriptor_stats},
+        op_stats_{op_stats},
+        phase_sample_{phase_sample},
+        prefetch_distance_{prefetch_distance},
+        track_workers_{!process_shared
+                       && (numa_stats || abort_stats || descriptor_stats || op_stats
+                           || phase_sample > 0 || placement.PinWorkers())},
+        init_thread_num_{(placement.GetPolicy() == kFirstTouch) ? worker_num : init_thread_num},
+        worker_stats_{worker_num}
   {
-    // a lambda function to initialize target fields
-    auto f = [&](const size_t thread_id, const size_t n) {
-      for (size_t i = 0, id = thread_id; i < n; ++i, id += init_thread_num) {
-        target_fields_[id] = new uint64_t{0};
-      }
-    };
+    placement_.ApplyMemoryPolicy(target_fields_.GetRegion(), target_fields_.GetRegionSize());
 
-    // prepare MwCAS target fields with multi-threads
-    std::vector<std::thread> threads;
-    for (size_t i = 0; i < init_thread_num; ++i) {
-      const size_t n = (total_field_num + ((init_thread_num - 1) - i)) / init_thread_num;
-      threads.emplace_back(f, i, n);
+    // prepare MwCAS target fields with pinned threads (each worker touches its own partition
+    // if the first-touch policy is used)
+    RunWithPinnedThreads([&](const size_t begin, const size_t end) {
+      target_fields_.Initialize(begin, end, update_.UsesPointers());
+    });
+
+    if (numa_stats_) {
+      placement_.LoadPageNodes(target_fields_.GetRegion(), target_fields_.GetRegionSize());
     }
-    for (auto &&t : threads) t.join();
 
     // prepare descriptor pool for PMwCAS if needed
     if constexpr (std::is_same_v<Implementation, PMwCAS>) {
       // prepare PMwCAS descriptor pool
       ::pmwcas::InitLibrary(pmwcas::DefaultAllocator::Create, pmwcas::DefaultAllocator::Destroy,
                             pmwcas::LinuxEnvironment::Create, pmwcas::LinuxEnvironment::Destroy);
-      pmwcas_desc_pool = std::make_unique<PMwCAS>(static_cast<uint32_t>(8192 * worker_num),
+      const auto prev_mappings = MemoryRegion::GetAnonymousMappings();
+      const auto desc_num = kPMwCASDescPerWorker * worker_num;
+      pmwcas_desc_pool = std::make_unique<PMwCAS>(static_cast<uint32_t>(desc_num),
                                                   static_cast<uint32_t>(worker_num));
+
+      // PMwCAS allocates its pool internally, so advise the mappings created by the library
+      if (huge_page_mode_ != kNoHugePage) {
+        for (auto &&mapping : MemoryRegion::GetAnonymousMappings()) {
+          if (std::find(prev_mappings.begin(), prev_mappings.end(), mapping)
+              != prev_mappings.end()) {
+            continue;
+          }
+          const auto &[begin, end] = mapping;
+          MemoryRegion::Advise(reinterpret_cast<void *>(begin), end - begin, true);
+          pool_mappings_.emplace_back(mapping);
+        }
+      }
     }
   }
 
@@ -78,30 +196,845 @@ class MwCASTarget
 
   ~MwCASTarget()
   {
-    for (auto &&addr : target_fields_) {
-      delete addr;
-    }
+    // release pages in parallel before the memory region is unmapped
+    RunWithPinnedThreads([&](const size_t begin, const size_t end) {
+      target_fields_.Release(begin, end);
+    });
   }
 
   /*################################################################################################
    * Public utility functions
    *##############################################################################################*/
 
-  void Execute(const Operation &ops);
+  void
+  Execute(const Operation &ops)
+  {
+    if (!track_workers_) {
+      Perform(ops);
+      return;
+    }
+
+    auto &stats = GetWorkerStats();
+    const auto start_time = (op_stats_) ? Clock_t::now() : Clock_t::time_point{};
+    auto *probe = (descriptor_stats_) ? &stats.probe : nullptr;
+    size_t abort_num{};
+    if (phase_sample_ > 0 && ops.GetType() == kUpdate && ++stats.update_num % phase_sample_ == 0) {
+      PhaseTimer timer{};
+      abort_num = Perform(ops, timer, probe);
+      RecordPhases(timer, stats);
+    } else {
+      abort_num = Perform(ops, NoPhaseTimer{}, probe);
+    }
+    ++stats.exec_num;
+    if (ops.GetType() == kRead) ++stats.read_num;
+    if constexpr (kRetryStats) {
+      if (abort_stats_ && ops.GetType() == kUpdate) RecordRetries(abort_num, stats);
+    }
+    if (op_stats_) RecordLatency(ops, start_time, stats);
+    if (numa_stats_) RecordAccesses(ops, stats);
+  }
 
-  const std::vector<uint64_t *> &
+  /**
+   * @brief Decode target addresses of a compact operation and execute it.
+   *
+   * @param ops a compact operation with the indices of target fields.
+   */
+  void
+  Execute(const CompactOperation &ops)
+  {
+    Execute(ops.Decode(target_fields_));
+  }
+
+  /**
+   * @brief Execute consecutive operations with software prefetching.
+   *
+   * While an operation is executed, the target words of the operation after the next `d - 1`
+   * ones are prefetched (`d` is a prefetch distance), so that the cache misses of up to `d`
+   * operations overlap. Compact operations are decoded for prefetching, and their entries are
+   * prefetched `2d` operations ahead. Operations are executed one by one without prefetching
+   * if the distance is zero.
+   *
+   * @tparam Op the class of operations.
+   * @param ops the head of consecutive operations.
+   * @param n the number of operations.
+   */
+  template <class Op>
+  void
+  ExecuteBatch(  //
+      const Op *ops,
+      const size_t n)
+  {
+    const auto dist = prefetch_distance_;
+    if (dist == 0) {
+      for (size_t i = 0; i < n; ++i) {
+        Execute(ops[i]);
+      }
+      return;
+    }
+
+    // fill the pipeline with the first operations
+    for (size_t i = 0; i < std::min(dist, n); ++i) {
+      if constexpr (std::is_same_v<Op, CompactOperation>) {
+        if (i + dist < n) __builtin_prefetch(&ops[i + dist]);
+      }
+      Prefetch(ops[i]);
+    }
+    for (size_t i = 0; i < n; ++i) {
+      if constexpr (std::is_same_v<Op, CompactOperation>) {
+        if (i + 2 * dist < n) __builtin_prefetch(&ops[i + 2 * dist]);
+      }
+      if (i + dist < n) Prefetch(ops[i + dist]);
+      Execute(ops[i]);
+    }
+  }
+
+  const TargetFields &
   ReferTargetFields() const
   {
     return target_fields_;
   }
 
+  /**
+   * @brief Forget registered workers so that the next threads are registered from scratch.
+   *
+   * This function is used to discard threads for warming up.
+   */
+  void
+  ResetWorkers()
+  {
+    instance_id_ = instance_counter_.fetch_add(1, std::memory_order_relaxed);
+    registered_num_.store(0, std::memory_order_relaxed);
+    for (auto &&stats : worker_stats_) {
+      stats = WorkerStats{};
+    }
+  }
+
+  /**
+   * @brief Add which allocations are actually backed by huge pages to a report.
+   *
+   * @param report a report to add results.
+   */
+  void
+  ReportHugePages(Report &report) const
+  {
+    if (huge_page_mode_ == kNoHugePage) return;
+
+    const auto *region = target_fields_.GetRegion();
+    const auto region_size = target_fields_.GetRegionSize();
+    report.Add("huge pages", "requested mode", MemoryRegion::ToString(huge_page_mode_));
+    report.Add("huge pages", "target fields mode",
+               MemoryRegion::ToString(target_fields_.GetHugePageMode()));
+    report.Add("huge pages", "target fields [MiB]", ToMiB(region_size));
+    report.Add("huge pages", "target fields on huge pages [MiB]",
+               ToMiB(MemoryRegion::CountHugePageBytes(region, region_size)));
+
+    if constexpr (std::is_same_v<Implementation, PMwCAS>) {
+      size_t pool_size = 0;
+      size_t huge_size = 0;
+      for (auto &&[begin, end] : pool_mappings_) {
+        const auto size = end - begin;
+        pool_size += size;
+        huge_size += MemoryRegion::CountHugePageBytes(reinterpret_cast<void *>(begin), size);
+      }
+      report.Add("huge pages", "descriptor pool mode", "thp");
+      report.Add("huge pages", "descriptor pool [MiB]", ToMiB(pool_size));
+      report.Add("huge pages", "descriptor pool on huge pages [MiB]", ToMiB(huge_size));
+    }
+  }
+
+  /**
+   * @brief Add the measured ratio of failed MwCAS attempts to a report.
+   *
+   * In addition to aggregated ratios, the distribution of retries per operation is added as a
+   * histogram with power-of-two buckets.
+   *
+   * @param report a report to add results.
+   */
+  void
+  ReportAbortStats(Report &report) const
+  {
+    if (!abort_stats_) return;
+
+    // reads never abort, and so only updates are counted
+    size_t exec_num = 0;
+    size_t abort_num = 0;
+    size_t max_retry_num = 0;
+    std::array<size_t, kRetryBucketNum> retry_hist{};
+    for (auto &&stats : worker_stats_) {
+      exec_num += stats.exec_num - stats.read_num;
+      abort_num += stats.abort_num;
+      max_retry_num = std::max(max_retry_num, stats.max_retry_num);
+      for (size_t i = 0; i < kRetryBucketNum; ++i) {
+        retry_hist[i] += stats.retry_hist[i];
+      }
+    }
+
+    const auto attempt_num = exec_num + abort_num;
+    const auto abort_rate = (attempt_num == 0) ? 0.0 : static_cast<double>(abort_num) / attempt_num;
+    report.Add("conflicts", "measured abort rate", abort_rate);
+    report.Add("conflicts", "aborts per operation",
+               (exec_num == 0) ? 0.0 : static_cast<double>(abort_num) / exec_num);
+    report.Add("conflicts", "total attempts", attempt_num);
+    report.Add("conflicts", "success ratio", 1.0 - abort_rate);
+    report.Add("conflicts", "max retries", max_retry_num);
+
+    size_t last_bucket = 0;
+    for (size_t i = 0; i < kRetryBucketNum; ++i) {
+      if (retry_hist[i] > 0) last_bucket = i;
+    }
+    for (size_t i = 0; i <= last_bucket && exec_num > 0; ++i) {
+      report.Add("conflicts", "retries " + GetRetryBucketName(i) + " ratio",
+                 static_cast<double>(retry_hist[i]) / exec_num);
+    }
+  }
+
+  /**
+   * @brief Add throughput and average latency of each MwCAS width and operation type to a
+   * report.
+   *
+   * The target capacity and the descriptor size are always added, but the rows of each width
+   * or type are added only if operations vary in it.
+   *
+   * @param report a report to add results.
+   */
+  void
+  ReportOperationStats(Report &report) const
+  {
+    if (!op_stats_) return;
+
+    std::array<size_t, kTargetNum + 1> width_nums{};
+    std::array<size_t, kTargetNum + 1> width_nanos{};
+    std::array<double, kTargetNum + 1> width_throughputs{};
+    std::array<size_t, kOperationTypeNum> type_nums{};
+    std::array<size_t, kOperationTypeNum> type_nanos{};
+    std::array<double, kOperationTypeNum> type_throughputs{};
+    for (auto &&stats : worker_stats_) {
+      const auto sec = std::chrono::duration<double>(stats.end_time - stats.start_time).count();
+      if (sec <= 0) continue;
+
+      for (size_t w = 1; w <= kTargetNum; ++w) {
+        width_nums[w] += stats.width_exec_nums[w];
+        width_nanos[w] += stats.width_latency_nanos[w];
+        width_throughputs[w] += stats.width_exec_nums[w] / sec;
+      }
+      for (size_t t = 0; t < kOperationTypeNum; ++t) {
+        type_nums[t] += stats.type_exec_nums[t];
+        type_nanos[t] += stats.type_latency_nanos[t];
+        type_throughputs[t] += stats.type_exec_nums[t] / sec;
+      }
+    }
+
+    report.Add("widths", "target capacity", kTargetNum);
+    report.Add("widths", "descriptor size [B]",
+               MwCASProcedure<Implementation>::GetDescriptorSize());
+    AddOperationStats(report, "widths", "width ", 1, width_nums, width_nanos, width_throughputs);
+    AddOperationStats(report, "operation types", "", 0, type_nums, type_nanos, type_throughputs);
+  }
+
+  /**
+   * @brief Add a breakdown of update cycles into phases to a report.
+   *
+   * Phases that never appear in an implementation (e.g., epochs except for PMwCAS) are omitted.
+   *
+   * @param report a report to add results.
+   */
+  void
+  ReportPhaseStats(Report &report) const
+  {
+    if (phase_sample_ == 0) return;
+
+    size_t sample_num = 0;
+    std::array<size_t, kPhaseNum> phase_cycles{};
+    for (auto &&stats : worker_stats_) {
+      sample_num += stats.phase_sample_num;
+      for (size_t i = 0; i < kPhaseNum; ++i) {
+        phase_cycles[i] += stats.phase_cycles[i];
+      }
+    }
+    if (sample_num == 0) return;
+
+    size_t total_cycles = 0;
+    for (auto &&cycles : phase_cycles) total_cycles += cycles;
+    report.Add("phases", "sampled updates", sample_num);
+    report.Add("phases", "total [cycles/op]", static_cast<double>(total_cycles) / sample_num);
+    for (size_t i = 0; i < kPhaseNum; ++i) {
+      if (phase_cycles[i] == 0) continue;
+
+      const std::string name = ToString(static_cast<Phase>(i));
+      const auto cycles = static_cast<double>(phase_cycles[i]);
+      report.Add("phases", name + " [cycles/op]", cycles / sample_num);
+      report.Add("phases", name + " ratio", cycles / total_cycles);
+    }
+  }
+
+  /**
+   * @brief Add how often operations found in-progress MwCAS operations to a report.
+   *
+   * @param report a report to add results.
+   */
+  void
+  ReportDescriptorStats(Report &report) const
+  {
+    if (!descriptor_stats_) return;
+
+    DescriptorProbe probe{};
+    for (auto &&stats : worker_stats_) {
+      probe.Merge(stats.probe);
+    }
+
+    const auto read_num = probe.GetReadNum();
+    const auto attempt_num = probe.GetAttemptNum();
+    const auto failure_num = probe.GetFailureNum();
+    const auto peek_num = read_num + attempt_num;
+    if (read_num > 0) {
+      report.Add("descriptors", "reads finding descriptors ratio",
+                 static_cast<double>(probe.GetReadHitNum()) / read_num);
+    }
+    if (attempt_num > 0) {
+      report.Add("descriptors", "update attempts finding descriptors ratio",
+                 static_cast<double>(probe.GetAttemptHitNum()) / attempt_num);
+    }
+    report.Add("descriptors", "descriptor words per peek",
+               (peek_num == 0) ? 0.0 : static_cast<double>(probe.GetWordHitNum()) / peek_num);
+    report.Add("descriptors", "failed commits", failure_num);
+    if (failure_num > 0) {
+      report.Add("descriptors", "failed commits finding descriptors ratio",
+                 static_cast<double>(probe.GetFailureHitNum()) / failure_num);
+    }
+  }
+
+  /**
+   * @brief Add per-node throughput and remote-access ratios to a report.
+   *
+   * @param report a report to add results.
+   */
+  void
+  ReportNUMAStats(Report &report) const
+  {
+    if (!numa_stats_) return;
+
+    const auto node_num = placement_.GetNodeNum();
+    std::vector<size_t> worker_nums(node_num, 0);
+    std::vector<size_t> access_nums(node_num, 0);
+    std::vector<size_t> remote_nums(node_num, 0);
+    std::vector<double> throughputs(node_num, 0);
+    for (auto &&stats : worker_stats_) {
+      if (stats.exec_num == 0) continue;
+
+      const auto node = stats.node;
+      const auto sec = std::chrono::duration<double>(stats.end_time - stats.start_time).count();
+      ++worker_nums[node];
+      access_nums[node] += stats.access_num;
+      remote_nums[node] += stats.remote_access_num;
+      if (sec > 0) throughputs[node] += stats.timed_exec_num / sec;
+    }
+
+    std::vector<size_t> field_nums(node_num, 0);
+    for (size_t i = 0; i < target_fields_.size(); ++i) {
+      ++field_nums[placement_.GetNodeOfAddr(target_fields_[i])];
+    }
+
+    for (size_t node = 0; node < node_num; ++node) {
+      const auto prefix = "node " + std::to_string(node) + " ";
+      const auto remote_ratio =
+          (access_nums[node] == 0)
+              ? 0.0
+              : static_cast<double>(remote_nums[node]) / access_nums[node];
+      report.Add("NUMA", prefix + "fields", field_nums[node]);
+      report.Add("NUMA", prefix + "workers", worker_nums[node]);
+      report.Add("NUMA", prefix + "throughput [Ops/s]", throughputs[node]);
+      report.Add("NUMA", prefix + "remote access ratio", remote_ratio);
+    }
+  }
+
  private:
+  /*################################################################################################
+   * Internal constants
+   *##############################################################################################*/
+
+  /// the number of operations between timestamps of each worker
+  static constexpr size_t kClockInterval = 256;
+
+  /// the number of histogram buckets of retries (zero, one, and each power-of-two range)
+  static constexpr size_t kRetryBucketNum = 16;
+
+  /*################################################################################################
+   * Internal classes
+   *##############################################################################################*/
+
+  /**
+   * @brief A class to hold statistics of each worker thread.
+   *
+   */
+  struct alignas(kCacheLineSize) WorkerStats {
+    /// the NUMA node of a worker
+    int node{0};
+
+    /// the number of executed operations
+    size_t exec_num{0};
+
+    /// the number of failed MwCAS attempts
+    size_t abort_num{0};
+
+    /// the maximum number of failed attempts in one operation
+    size_t max_retry_num{0};
+
+    /// the number of operations in each bucket of failed attempts
+    std::array<size_t, kRetryBucketNum> retry_hist{};
+
+    /// the number of executed read operations
+    size_t read_num{0};
+
+    /// the number of executed updates (only counted for sampling phases)
+    size_t update_num{0};
+
+    /// the number of updates whose phases are measured
+    size_t phase_sample_num{0};
+
+    /// the total cycles of each phase in sampled updates
+    std::array<size_t, kPhaseNum> phase_cycles{};
+
+    /// the counts of descriptors found in target words
+    DescriptorProbe probe{};
+
+    /// the number of executed operations of each width
+    std::array<size_t, kTargetNum + 1> width_exec_nums{};
+
+    /// the total latency of operations of each width in nanoseconds
+    std::array<size_t, kTargetNum + 1> width_latency_nanos{};
+
+    /// the number of executed operations of each type
+    std::array<size_t, kOperationTypeNum> type_exec_nums{};
+
+    /// the total latency of operations of each type in nanoseconds
+    std::array<size_t, kOperationTypeNum> type_latency_nanos{};
+
+    /// the number of executed operations until the last timestamp
+    size_t timed_exec_num{0};
+
+    /// the number of accessed target fields
+    size_t access_num{0};
+
+    /// the number of accessed target fields in remote nodes
+    size_t remote_access_num{0};
+
+    /// the time when a worker started
+    Clock_t::time_point start_time{};
+
+    /// the last timestamp of a worker
+    Clock_t::time_point end_time{};
+  };
+
+  /*################################################################################################
+   * Internal utility functions
+   *##############################################################################################*/
+
+  /**
+   * @brief Run a given function over partitions of target fields with pinned threads.
+   *
+   * Threads are pinned only if an explicit placement policy is set. With the default policy,
+   * pages are first touched by unpinned threads and so follow the scheduler as before.
+   *
+   * @tparam Func a function that receives the [begin, end) range of a partition.
+   * @param f a function to be run in each thread.
+   */
+  template <class Func>
+  void
+  RunWithPinnedThreads(Func &&f)
+  {
+    const auto total_field_num = target_fields_.size();
+    const auto pin_threads = placement_.GetPolicy() != kDefaultPolicy;
+
+    std::vector<std::thread> threads;
+    for (size_t i = 0, begin = 0; i < init_thread_num_; ++i) {
+      const size_t n = (total_field_num + ((init_thread_num_ - 1) - i)) / init_thread_num_;
+      threads.emplace_back([&, i, begin, n] {
+        if (pin_threads) placement_.PinThread(i);
+        f(begin, begin + n);
+      });
+      begin += n;
+    }
+    for (auto &&t : threads) t.join();
+  }
+
+  static constexpr double
+  ToMiB(const size_t bytes)
+  {
+    return static_cast<double>(bytes) / (1UL << 20UL);
+  }
+
+  /**
+   * @brief Touch the payload around each target word of an operation.
+   *
+   * @param ops target addresses of an MwCAS operation.
+   */
+  void
+  TouchPayloads(const Operation &ops) const
+  {
+    for (size_t i = 0; i < ops.GetWidth(); ++i) {
+      layout_.TouchPayload(ops.GetAddr(i));
+    }
+  }
+
+  /**
+   * @brief Prefetch the target words of an operation (for writing if it is an update).
+   *
+   * @param ops target addresses of an operation.
+   */
+  static void
+  Prefetch(const Operation &ops)
+  {
+    if (ops.GetType() == kUpdate) {
+      for (size_t i = 0; i < ops.GetWidth(); ++i) {
+        __builtin_prefetch(ops.GetAddr(i), 1);
+      }
+    } else {
+      for (size_t i = 0; i < ops.GetWidth(); ++i) {
+        __builtin_prefetch(ops.GetAddr(i), 0);
+      }
+    }
+  }
+
+  /**
+   * @brief Prefetch the target words of a compact operation without decoding all of them.
+   *
+   * @param ops a compact operation with the indices of target fields.
+   */
+  void
+  Prefetch(const CompactOperation &ops) const
+  {
+    if (ops.GetType() == kUpdate) {
+      for (size_t i = 0; i < ops.GetWidth(); ++i) {
+        __builtin_prefetch(target_fields_[ops.GetIndex(i)], 1);
+      }
+    } else {
+      for (size_t i = 0; i < ops.GetWidth(); ++i) {
+        __builtin_prefetch(target_fields_[ops.GetIndex(i)], 0);
+      }
+    }
+  }
+
+  /**
+   * @brief Get the statistics of a calling thread.
+   *
+   * A thread is registered as a worker (and pinned if needed) when it calls this function
+   * for the first time.
+   *
+   * @return the statistics of a calling thread.
+   */
+  WorkerStats &
+  GetWorkerStats()
+  {
+    thread_local size_t registered_id = 0;
+    thread_local WorkerStats *stats = nullptr;
+
+    if (registered_id != instance_id_) {
+      const auto worker_id = registered_num_.fetch_add(1, std::memory_order_relaxed);
+      // keep the CPU of a thread that has generated its operations on its own node
+      if (placement_.PinWorkers() && !NUMAPlacement::IsThreadPinned()) {
+        placement_.PinThread(worker_id);
+      }
+
+      stats = &(worker_stats_[worker_id % worker_stats_.size()]);
+      stats->node = placement_.GetCurrentNode();
+      stats->start_time = Clock_t::now();
+      registered_id = instance_id_;
+    }
+
+    return *stats;
+  }
+
+  /**
+   * @brief Perform an operation according to its type.
+   *
+   * Payloads are touched only by updates because reads are used to measure MwCAS-aware read
+   * procedures. If operations are not sorted in advance, updates sort their targets here so
+   * that the ordering cost is included in measurement as real callers pay it.
+   *
+   * @param ops target addresses of an operation.
+   * @param timer a timer to attribute cycles to the phases of an operation.
+   * @param probe a probe to count descriptors in target words (nullptr if not counted).
+   * @return the number of failed MwCAS attempts.
+   */
+  template <class Timer = NoPhaseTimer>
+  size_t
+  Perform(  //
+      const Operation &ops,
+      Timer &&timer = Timer{},
+      DescriptorProbe *probe = nullptr) const
+  {
+    if (ops.GetType() == kRead) {
+      MwCASProcedure<Implementation>::Read(ops, probe);
+      return 0;
+    }
+
+    size_t abort_num{};
+    timer.Start();
+    if (presort_) {
+      abort_num = Update(ops, timer, probe);
+    } else {
+      auto sorted = ops;
+      sorted.SortTargets();
+      timer.Lap(kSortPhase);
+      abort_num = Update(sorted, timer, probe);
+    }
+    TouchPayloads(ops);
+    return abort_num;
+  }
+
+  /**
+   * @brief Perform an MwCAS operation with a selected contention-management policy.
+   *
+   * @tparam Timer a timer to attribute cycles to the phases of an operation.
+   * @param ops sorted target addresses of an MwCAS operation.
+   * @param timer a started timer.
+   * @param probe a probe to count descriptors in target words (nullptr if not counted).
+   * @return the number of failed MwCAS attempts.
+   */
+  template <class Timer>
+  size_t
+  Update(  //
+      const Operation &ops,
+      Timer &timer,
+      DescriptorProbe *probe) const
+  {
+    using Procedure = MwCASProcedure<Implementation>;
+
+    switch (backoff_) {
+      case kExponentialBackoff:
+        return Procedure::template Execute<ExponentialBackoff>(ops, update_, timer, probe);
+      case kRandomizedBackoff:
+        return Procedure::template Execute<RandomizedBackoff>(ops, update_, timer, probe);
+      case kYieldBackoff:
+        return Procedure::template Execute<YieldBackoff>(ops, update_, timer, probe);
+      case kAdaptiveBackoff:
+        return Procedure::template Execute<AdaptiveBackoff>(ops, update_, timer, probe);
+      case kNoBackoff:
+      default:
+        return Procedure::template Execute<NoBackoff>(ops, update_, timer, probe);
+    }
+  }
+
+  /**
+   * @param retry_num the number of failed attempts in an operation.
+   * @return the histogram bucket of the number (i.e., [0], [1], [2, 3], [4, 7], ...).
+   */
+  static constexpr size_t
+  GetRetryBucket(const size_t retry_num)
+  {
+    size_t bucket = 0;
+    for (auto n = retry_num; n > 0 && bucket < kRetryBucketNum - 1; n >>= 1UL) {
+      ++bucket;
+    }
+    return bucket;
+  }
+
+  /**
+   * @param bucket a histogram bucket of retries.
+   * @return the range of the bucket (e.g., "4-7").
+   */
+  static std::string
+  GetRetryBucketName(const size_t bucket)
+  {
+    if (bucket == 0) return "0";
+
+    const auto begin = 1UL << (bucket - 1);
+    if (bucket == kRetryBucketNum - 1) return std::to_string(begin) + "+";
+    if (bucket == 1) return "1";
+    return std::to_string(begin) + "-" + std::to_string((begin << 1UL) - 1);
+  }
+
+  /**
+   * @brief Record failed MwCAS attempts of an update.
+   *
+   * @param abort_num the number of failed attempts.
+   * @param stats the statistics of a calling thread.
+   */
+  static void
+  RecordRetries(  //
+      const size_t abort_num,
+      WorkerStats &stats)
+  {
+    stats.abort_num += abort_num;
+    stats.max_retry_num = std::max(stats.max_retry_num, abort_num);
+    ++stats.retry_hist[GetRetryBucket(abort_num)];
+  }
+
+  /**
+   * @brief Record the cycles of each phase in a sampled update.
+   *
+   * @param timer a timer that has measured an update.
+   * @param stats the statistics of a calling thread.
+   */
+  static void
+  RecordPhases(  //
+      const PhaseTimer &timer,
+      WorkerStats &stats)
+  {
+    const auto &cycles = timer.GetCycles();
+    for (size_t i = 0; i < kPhaseNum; ++i) {
+      stats.phase_cycles[i] += cycles[i];
+    }
+    ++stats.phase_sample_num;
+  }
+
+  /**
+   * @brief Record the latency of an operation for its width and type.
+   *
+   * @param ops target addresses of an operation.
+   * @param start_time the time when the operation started.
+   * @param stats the statistics of a calling thread.
+   */
+  static void
+  RecordLatency(  //
+      const Operation &ops,
+      const Clock_t::time_point &start_time,
+      WorkerStats &stats)
+  {
+    const auto end_time = Clock_t::now();
+    const size_t latency =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(end_time - start_time).count();
+    ++stats.width_exec_nums[ops.GetWidth()];
+    stats.width_latency_nanos[ops.GetWidth()] += latency;
+    ++stats.type_exec_nums[ops.GetType()];
+    stats.type_latency_nanos[ops.GetType()] += latency;
+    stats.timed_exec_num = stats.exec_num;
+    stats.end_time = end_time;
+  }
+
+  /**
+   * @brief Add the ratio, throughput, and average latency of each kind of operations.
+   *
+   * Nothing is added if all the operations are of the same kind.
+   *
+   * @param report a report to add results.
+   * @param section the section of rows.
+   * @param prefix a prefix of keys.
+   * @param begin the first kind.
+   * @param exec_nums the number of executed operations of each kind.
+   * @param latency_nanos the total latency of each kind in nanoseconds.
+   * @param throughputs the throughput of each kind.
+   */
+  template <size_t N>
+  static void
+  AddOperationStats(  //
+      Report &report,
+      const std::string &section,
+      const std::string &prefix,
+      const size_t begin,
+      const std::array<size_t, N> &exec_nums,
+      const std::array<size_t, N> &latency_nanos,
+      const std::array<double, N> &throughputs)
+  {
+    size_t total_num = 0;
+    size_t kind_num = 0;
+    for (size_t i = begin; i < N; ++i) {
+      total_num += exec_nums[i];
+      if (exec_nums[i] > 0) ++kind_num;
+    }
+    if (kind_num <= 1) return;
+
+    for (size_t i = begin; i < N; ++i) {
+      if (exec_nums[i] == 0) continue;
+
+      const auto key = prefix + ((begin == 0) ? ToString(static_cast<OperationType>(i))
+                                              : std::to_string(i));
+      report.Add(section, key + " ratio", static_cast<double>(exec_nums[i]) / total_num);
+      report.Add(section, key + " throughput [Ops/s]", throughputs[i]);
+      report.Add(section, key + " average latency [ns]",
+                 static_cast<double>(latency_nanos[i]) / exec_nums[i]);
+    }
+  }
+
+  /**
+   * @brief Record which NUMA nodes are accessed by an operation.
+   *
+   * @param ops target addresses of an MwCAS operation.
+   * @param stats the statistics of a calling thread.
+   */
+  void
+  RecordAccesses(  //
+      const Operation &ops,
+      WorkerStats &stats) const
+  {
+    for (size_t i = 0; i < ops.GetWidth(); ++i) {
+      if (placement_.GetNodeOfAddr(ops.GetAddr(i)) != stats.node) ++stats.remote_access_num;
+    }
+    stats.access_num += ops.GetWidth();
+
+    if (stats.exec_num % kClockInterval == 0) {
+      stats.timed_exec_num = stats.exec_num;
+      stats.end_time = Clock_t::now();
+    }
+  }
+
+  /*################################################################################################
+   * Internal static variables
+   *##############################################################################################*/
+
+  /// a counter to identify instances (zero is reserved for unregistered threads)
+  static inline std::atomic_size_t instance_counter_{1};
+
   /*################################################################################################
    * Internal member variables
    *##############################################################################################*/
 
   /// target fields of MwCAS operations
-  std::vector<uint64_t *> target_fields_;
+  TargetFields target_fields_;
+
+  /// a layout of records that embed target words
+  const Layout layout_;
+
+  /// a function to compute new values of target words
+  const UpdateFunction update_;
+
+  /// a flag indicating that targets have been sorted in generation
+  const bool presort_;
+
+  /// a contention-management policy between failed MwCAS attempts
+  const BackoffPolicy backoff_;
+
+  /// a requested backing mode of memory regions
+  const HugePageMode huge_page_mode_;
+
+  /// anonymous mappings allocated by PMwCAS for its descriptor pool
+  std::vector<std::pair<uintptr_t, uintptr_t>> pool_mappings_{};
+
+  /// placement of target fields and worker threads
+  NUMAPlacement placement_;
+
+  /// a flag to collect per-node statistics
+  const bool numa_stats_;
+
+  /// a flag to count failed MwCAS attempts
+  const bool abort_stats_;
+
+  /// a flag to count descriptors found in target words (only for worker threads)
+  const bool descriptor_stats_;
+
+  /// a flag to measure throughput and latency of each width and type of operations
+  const bool op_stats_;
+
+  /// the interval of updates whose phases are measured (zero if phases are not measured)
+  const size_t phase_sample_;
+
+  /// the number of operations whose targets are prefetched ahead (zero if not prefetched)
+  const size_t prefetch_distance_;
+
+  /// a flag to register worker threads
+  const bool track_workers_;
+
+  /// the number of threads for initialization and teardown
+  const size_t init_thread_num_;
+
+  /// the ID of this instance
+  size_t instance_id_{instance_counter_.fetch_add(1, std::memory_order_relaxed)};
+
+  /// the number of registered worker threads
+  std::atomic_size_t registered_num_{0};
+
+  /// statistics of each worker thread
+  std::vector<WorkerStats> worker_stats_;
 };
 
 /*##################################################################################################
@@ -109,74 +1042,279 @@ class MwCASTarget
  *################################################################################################*/
 
 template <>
-inline void
-MwCASTarget<MwCAS>::Execute(const Operation &ops)
+template <class Backoff, class Timer>
+inline size_t
+MwCASProcedure<MwCAS>::Execute(  //
+    const Operation &ops,
+    const UpdateFunction &update,
+    Timer &timer,
+    DescriptorProbe *probe)
 {
-  while (true) {
-    MwCAS desc{};
-    for (size_t i = 0; i < kTargetNum; ++i) {
-      const auto addr = ops.GetAddr(i);
-      const auto old_val = MwCAS::Read<size_t>(addr);
-      const auto new_val = old_val + 1;
-      desc.AddMwCASTarget(addr, old_val, new_val);
+  const auto width = ops.GetWidth();
+  UpdateFunction::Values_t old_vals{};
+  Backoff backoff{};
+  for (size_t abort_num = 0; true; ++abort_num) {
+    if (probe != nullptr) probe->PeekRead(ops);
+    for (size_t i = 0; i < width; ++i) {
+      old_vals[i] = MwCAS::Read<size_t>(ops.GetAddr(i));
+    }
+    timer.Lap(kReadPhase);
+    update.Think(old_vals);
+    timer.Lap(kThinkPhase);
+    if (!update.Holds(old_vals)) {
+      backoff.Complete();
+      return abort_num;
+    }
+
+    // use a descriptor in a shared memory region if workers are processes
+    MwCAS local_desc{};
+    auto &desc = (shared_mwcas_desc == nullptr) ? local_desc : *(new (shared_mwcas_desc) MwCAS{});
+    timer.Lap(kAllocatePhase);
+    for (size_t i = 0; i < width; ++i) {
+      desc.AddMwCASTarget(ops.GetAddr(i), old_vals[i], update.GetNewValue(old_vals, width, i));
     }
+    timer.Lap(kBuildPhase);
 
-    if (desc.MwCAS()) break;
+    const auto success = desc.MwCAS();
+    timer.Lap(kCommitPhase);
+    if (success) {
+      backoff.Complete();
+      return abort_num;
+    }
+    if (probe != nullptr) probe->PeekFailure(ops);
+    backoff.Wait();
+    timer.Lap(kBackoffPhase);
   }
 }
 
 template <>
 inline void
-MwCASTarget<PMwCAS>::Execute(const Operation &ops)
+MwCASProcedure<MwCAS>::Read(  //
+    const Operation &ops,
+    DescriptorProbe *probe)
+{
+  if (probe != nullptr) probe->PeekRead(ops);
+  size_t sum = 0;
+  for (size_t i = 0; i < ops.GetWidth(); ++i) {
+    sum += MwCAS::Read<size_t>(ops.GetAddr(i));
+  }
+  sink_ = sum;
+}
+
+template <>
+constexpr size_t
+MwCASProcedure<MwCAS>::GetDescriptorSize()
+{
+  return sizeof(MwCAS);
+}
+
+template <>
+template <class Backoff, class Timer>
+inline size_t
+MwCASProcedure<PMwCAS>::Execute(  //
+    const Operation &ops,
+    const UpdateFunction &update,
+    Timer &timer,
+    DescriptorProbe *probe)
 {
   using PMwCASField = ::pmwcas::MwcTargetField<uint64_t>;
 
-  while (true) {
-    auto desc = pmwcas_desc_pool->AllocateDescriptor();
+  const auto width = ops.GetWidth();
+  UpdateFunction::Values_t old_vals{};
+  Backoff backoff{};
+  for (size_t abort_num = 0; true; ++abort_num) {
     auto epoch = pmwcas_desc_pool->GetEpoch();
     epoch->Protect();
-    for (size_t i = 0; i < kTargetNum; ++i) {
-      const auto addr = ops.GetAddr(i);
-      const auto old_val = reinterpret_cast<PMwCASField *>(addr)->GetValueProtected();
-      const auto new_val = old_val + 1;
-      desc->AddEntry(addr, old_val, new_val);
+    timer.Lap(kEpochPhase);
+    if (probe != nullptr) probe->PeekRead(ops);
+    for (size_t i = 0; i < width; ++i) {
+      old_vals[i] = reinterpret_cast<PMwCASField *>(ops.GetAddr(i))->GetValueProtected();
     }
-    auto success = desc->MwCAS();
+    timer.Lap(kReadPhase);
+    update.Think(old_vals);
+    timer.Lap(kThinkPhase);
+    if (!update.Holds(old_vals)) {
+      epoch->Unprotect();
+      timer.Lap(kEpochPhase);
+      backoff.Complete();
+      return abort_num;
+    }
+
+    // allocate a descriptor only for a commit because an unused one is never returned to the pool
+    auto desc = pmwcas_desc_pool->AllocateDescriptor();
+    timer.Lap(kAllocatePhase);
+    for (size_t i = 0; i < width; ++i) {
+      desc->AddEntry(ops.GetAddr(i), old_vals[i], update.GetNewValue(old_vals, width, i));
+    }
+    timer.Lap(kBuildPhase);
+    const auto success = desc->MwCAS();
+    timer.Lap(kCommitPhase);
     epoch->Unprotect();
+    timer.Lap(kEpochPhase);
 
-    if (success) break;
+    if (success) {
+      backoff.Complete();
+      return abort_num;
+    }
+    if (probe != nullptr) probe->PeekFailure(ops);
+    backoff.Wait();
+    timer.Lap(kBackoffPhase);
   }
 }
 
 template <>
 inline void
-MwCASTarget<AOPT>::Execute(const Operation &ops)
+MwCASProcedure<PMwCAS>::Read(  //
+    const Operation &ops,
+    DescriptorProbe *probe)
+{
+  using PMwCASField = ::pmwcas::MwcTargetField<uint64_t>;
+
+  auto epoch = pmwcas_desc_pool->GetEpoch();
+  epoch->Protect();
+  if (probe != nullptr) probe->PeekRead(ops);
+  size_t sum = 0;
+  for (size_t i = 0; i < ops.GetWidth(); ++i) {
+    sum += reinterpret_cast<PMwCASField *>(ops.GetAddr(i))->GetValueProtected();
+  }
+  epoch->Unprotect();
+  sink_ = sum;
+}
+
+template <>
+constexpr size_t
+MwCASProcedure<PMwCAS>::GetDescriptorSize()
+{
+  return sizeof(::pmwcas::Descriptor);
+}
+
+template <>
+template <class Backoff, class Timer>
+inline size_t
+MwCASProcedure<AOPT>::Execute(  //
+    const Operation &ops,
+    const UpdateFunction &update,
+    Timer &timer,
+    DescriptorProbe *probe)
 {
-  while (true) {
+  const auto width = ops.GetWidth();
+  UpdateFunction::Values_t old_vals{};
+  Backoff backoff{};
+  for (size_t abort_num = 0; true; ++abort_num) {
+    if (probe != nullptr) probe->PeekRead(ops);
+    for (size_t i = 0; i < width; ++i) {
+      old_vals[i] = AOPT::Read<size_t>(ops.GetAddr(i));
+    }
+    timer.Lap(kReadPhase);
+    update.Think(old_vals);
+    timer.Lap(kThinkPhase);
+    if (!update.Holds(old_vals)) {
+      backoff.Complete();
+      return abort_num;
+    }
+
     auto desc = AOPT::GetDescriptor();
-    for (size_t i = 0; i < kTargetNum; ++i) {
-      const auto addr = ops.GetAddr(i);
-      const auto old_val = AOPT::Read<size_t>(addr);
-      const auto new_val = old_val + 1;
-      desc->AddMwCASTarget(addr, old_val, new_val);
+    timer.Lap(kAllocatePhase);
+    for (size_t i = 0; i < width; ++i) {
+      desc->AddMwCASTarget(ops.GetAddr(i), old_vals[i], update.GetNewValue(old_vals, width, i));
     }
+    timer.Lap(kBuildPhase);
 
-    if (desc->MwCAS()) break;
+    const auto success = desc->MwCAS();
+    timer.Lap(kCommitPhase);
+    if (success) {
+      backoff.Complete();
+      return abort_num;
+    }
+    if (probe != nullptr) probe->PeekFailure(ops);
+    backoff.Wait();
+    timer.Lap(kBackoffPhase);
   }
 }
 
 template <>
 inline void
-MwCASTarget<SingleCAS>::Execute(const Operation &ops)
+MwCASProcedure<AOPT>::Read(  //
+    const Operation &ops,
+    DescriptorProbe *probe)
+{
+  if (probe != nullptr) probe->PeekRead(ops);
+  size_t sum = 0;
+  for (size_t i = 0; i < ops.GetWidth(); ++i) {
+    sum += AOPT::Read<size_t>(ops.GetAddr(i));
+  }
+  sink_ = sum;
+}
+
+template <>
+constexpr size_t
+MwCASProcedure<AOPT>::GetDescriptorSize()
+{
+  return sizeof(AOPT);
+}
+
+template <>
+template <class Backoff, class Timer>
+inline size_t
+MwCASProcedure<SingleCAS>::Execute(  //
+    const Operation &ops,
+    const UpdateFunction &update,
+    Timer &timer,
+    DescriptorProbe *probe)
 {
-  for (size_t i = 0; i < kTargetNum; ++i) {
+  const auto width = ops.GetWidth();
+  UpdateFunction::Values_t old_vals{};
+  if (probe != nullptr) probe->PeekRead(ops);
+  for (size_t i = 0; i < width; ++i) {
+    old_vals[i] = reinterpret_cast<SingleCAS *>(ops.GetAddr(i))->load(std::memory_order_relaxed);
+  }
+  timer.Lap(kReadPhase);
+  update.Think(old_vals);
+  timer.Lap(kThinkPhase);
+  Backoff backoff{};
+  if (!update.Holds(old_vals)) {
+    backoff.Complete();
+    return 0;
+  }
+
+  // each word is updated independently, and so a failed CAS only retries the word
+  size_t abort_num = 0;
+  for (size_t i = 0; i < width; ++i) {
     auto target = reinterpret_cast<SingleCAS *>(ops.GetAddr(i));
-    auto old_val = target->load(std::memory_order_relaxed);
-    auto new_val = old_val + 1;
-    while (!target->compare_exchange_weak(old_val, new_val, std::memory_order_relaxed)) {
-      new_val = old_val + 1;
+    auto new_val = update.GetNewValue(old_vals, width, i);
+    while (!target->compare_exchange_weak(old_vals[i], new_val, std::memory_order_relaxed)) {
+      timer.Lap(kCommitPhase);
+      if (probe != nullptr) probe->PeekFailure(ops);
+      backoff.Wait();
+      timer.Lap(kBackoffPhase);
+      new_val = update.GetNewValue(old_vals, width, i);
+      ++abort_num;
     }
   }
+  timer.Lap(kCommitPhase);
+  backoff.Complete();
+  return abort_num;
+}
+
+template <>
+inline void
+MwCASProcedure<SingleCAS>::Read(  //
+    const Operation &ops,
+    DescriptorProbe *probe)
+{
+  if (probe != nullptr) probe->PeekRead(ops);
+  size_t sum = 0;
+  for (size_t i = 0; i < ops.GetWidth(); ++i) {
+    sum += reinterpret_cast<SingleCAS *>(ops.GetAddr(i))->load(std::memory_order_relaxed);
+  }
+  sink_ = sum;
+}
+
+template <>
+constexpr size_t
+MwCASProcedure<SingleCAS>::GetDescriptorSize()
+{
+  return 0;  // single-word CAS operations do not use descriptors
 }
 
 #endif  // MWCAS_BENCHMARK_MWCAS_TARGET_H
@@ -0,0 +1,386 @@
+/*
+ * Copyright 2021 Database Group, Nagoya University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MWCAS_BENCHMARK_NUMA_PLACEMENT_H
+#define MWCAS_BENCHMARK_NUMA_PLACEMENT_H
+
+#include <numa.h>
+#include <numaif.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+#include "common.hpp"
+
+/*##################################################################################################
+ * Global constants and enums
+ *################################################################################################*/
+
+/**
+ * @brief Placement policies of MwCAS target fields over NUMA nodes.
+ *
+ */
+enum NUMAPolicy
+{
+  /// leave placement to the default policy of an OS
+  kDefaultPolicy,
+  /// place all the fields on the node of the main thread
+  kLocal,
+  /// interleave pages over all the nodes
+  kInterleave,
+  /// place all the fields on a specified node
+  kBind,
+  /// let each worker first-touch the fields it owns
+  kFirstTouch,
+};
+
+/**
+ * @brief A class to control NUMA placement of target fields and worker threads.
+ *
+ * Worker threads are assigned to CPUs in node-major order (i.e., all the CPUs in node 0 are
+ * used first). If libnuma is not available, every CPU is regarded as in node 0.
+ */
+class NUMAPlacement
+{
+ public:
+  /*################################################################################################
+   * Public constructors and assignment operators
+   *##############################################################################################*/
+
+  /**
+   * @brief Construct a new NUMAPlacement object.
+   *
+   * @param policy a placement policy of target fields.
+   * @param bind_node a node for the kBind policy.
+   * @param pin_workers a flag to pin worker threads to CPUs.
+   */
+  NUMAPlacement(  //
+      const NUMAPolicy policy,
+      const int bind_node,
+      const bool pin_workers)
+      : policy_{policy},
+        bind_node_{bind_node},
+        pin_workers_{pin_workers || policy == kFirstTouch},
+        numa_enabled_{numa_available() >= 0}
+  {
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    sched_getaffinity(0, sizeof(allowed), &allowed);
+
+    // sort available CPUs in node-major order
+    const auto cpu_num = static_cast<int>(sysconf(_SC_NPROCESSORS_CONF));
+    const auto node_num = (numa_enabled_) ? numa_max_node() + 1 : 1;
+    for (int node = 0; node < node_num; ++node) {
+      for (int cpu = 0; cpu < cpu_num; ++cpu) {
+        if (!CPU_ISSET(cpu, &allowed) || GetNodeOfCPU(cpu) != node) continue;
+        cpus_.emplace_back(cpu);
+      }
+    }
+    if (cpus_.empty()) cpus_.emplace_back(0);
+  }
+
+  NUMAPlacement(const NUMAPlacement &) = default;
+  NUMAPlacement &operator=(const NUMAPlacement &obj) = default;
+  NUMAPlacement(NUMAPlacement &&) = default;
+  NUMAPlacement &operator=(NUMAPlacement &&) = default;
+
+  /*################################################################################################
+   * Public destructors
+   *##############################################################################################*/
+
+  ~NUMAPlacement() = default;
+
+  /*################################################################################################
+   * Public getters
+   *##############################################################################################*/
+
+  NUMAPolicy
+  GetPolicy() const
+  {
+    return policy_;
+  }
+
+  bool
+  PinWorkers() const
+  {
+    return pin_workers_;
+  }
+
+  /**
+   * @return the number of NUMA nodes.
+   */
+  size_t
+  GetNodeNum() const
+  {
+    return (numa_enabled_) ? numa_max_node() + 1 : 1;
+  }
+
+  /**
+   * @param worker_id the ID of a worker thread.
+   * @return a CPU for the worker thread.
+   */
+  int
+  GetCPU(const size_t worker_id) const
+  {
+    return cpus_[worker_id % cpus_.size()];
+  }
+
+  /**
+   * @param cpu the ID of a CPU.
+   * @return the NUMA node of the CPU.
+   */
+  int
+  GetNodeOfCPU(const int cpu) const
+  {
+    if (!numa_enabled_) return 0;
+
+    const auto node = numa_node_of_cpu(cpu);
+    return (node < 0) ? 0 : node;
+  }
+
+  /**
+   * @return the NUMA node of a calling thread.
+   */
+  int
+  GetCurrentNode() const
+  {
+    return GetNodeOfCPU(sched_getcpu());
+  }
+
+  /**
+   * @param addr a virtual address in target fields.
+   * @return the NUMA node where the address resides.
+   */
+  int
+  GetNodeOfAddr(const void *addr) const
+  {
+    const auto page_id = (reinterpret_cast<uintptr_t>(addr) - region_head_) / page_size_;
+    return page_nodes_[page_id];
+  }
+
+  /**
+   * @retval true if a calling thread has been pinned by any placement.
+   * @retval false otherwise.
+   */
+  static bool
+  IsThreadPinned()
+  {
+    return thread_pinned_;
+  }
+
+  /*################################################################################################
+   * Public utility functions
+   *##############################################################################################*/
+
+  /**
+   * @brief Pin a calling thread to the CPU of a given worker.
+   *
+   * @param worker_id the ID of a worker thread.
+   */
+  void
+  PinThread(const size_t worker_id) const
+  {
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    CPU_SET(GetCPU(worker_id), &cpu_set);
+    pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+    thread_pinned_ = true;
+  }
+
+  /**
+   * @brief Allocate the pages of a region on the node of a calling thread when touched.
+   *
+   * @param region the head address of a memory region.
+   * @param size the size of the memory region.
+   */
+  void
+  BindLocalMemory(  //
+      void *region,
+      const size_t size) const
+  {
+    if (!numa_enabled_ || size == 0) return;
+
+    // mbind requires a page-aligned range
+    const auto page_size = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+    const auto head = reinterpret_cast<uintptr_t>(region) & ~(page_size - 1);
+    const auto tail = reinterpret_cast<uintptr_t>(region) + size;
+    numa_setlocal_memory(reinterpret_cast<void *>(head), tail - head);
+  }
+
+  /**
+   * @brief Set a memory policy for a region before its pages are touched.
+   *
+   * @param region the head address of a memory region.
+   * @param size the size of the memory region.
+   */
+  void
+  ApplyMemoryPolicy(  //
+      void *region,
+      const size_t size) const
+  {
+    if (!numa_enabled_) return;
+
+    switch (policy_) {
+      case kLocal:
+        numa_tonode_memory(region, size, GetCurrentNode());
+        break;
+      case kInterleave:
+        numa_interleave_memory(region, size, numa_all_nodes_ptr);
+        break;
+      case kBind:
+        numa_tonode_memory(region, size, bind_node_);
+        break;
+      case kDefaultPolicy:
+      case kFirstTouch:
+      default:
+        break;
+    }
+  }
+
+  /**
+   * @brief Record the NUMA node of each page in a touched memory region.
+   *
+   * @param region the head address of a memory region.
+   * @param size the size of the memory region.
+   */
+  void
+  LoadPageNodes(  //
+      void *region,
+      const size_t size)
+  {
+    region_head_ = reinterpret_cast<uintptr_t>(region);
+    page_size_ = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+
+    const auto page_num = (size + page_size_ - 1) / page_size_;
+    page_nodes_.assign(page_num, 0);
+    if (!numa_enabled_) return;
+
+    std::vector<void *> pages{};
+    std::vector<int> status(page_num, 0);
+    pages.reserve(page_num);
+    for (size_t i = 0; i < page_num; ++i) {
+      pages.emplace_back(reinterpret_cast<std::byte *>(region) + i * page_size_);
+    }
+    numa_move_pages(0, page_num, pages.data(), nullptr, status.data(), 0);
+    for (size_t i = 0; i < page_num; ++i) {
+      page_nodes_[i] = (status[i] < 0) ? 0 : status[i];
+    }
+  }
+
+  /*################################################################################################
+   * Public static utilities
+   *##############################################################################################*/
+
+  /**
+   * @return the highest NUMA node (zero if NUMA is not available).
+   */
+  static int
+  GetMaxNode()
+  {
+    return (numa_available() >= 0) ? numa_max_node() : 0;
+  }
+
+  /**
+   * @param node a NUMA node.
+   * @retval true if memory can be allocated on the node.
+   * @retval false otherwise.
+   */
+  static bool
+  IsAvailableNode(const int node)
+  {
+    if (numa_available() < 0) return node == 0;
+    return node <= numa_max_node() && numa_bitmask_isbitset(numa_all_nodes_ptr, node) != 0;
+  }
+
+  /**
+   * @brief Parse a NUMA policy string.
+   *
+   * @param str a policy string ("default", "local", "interleave", "bind:<node>", or
+   * "first_touch").
+   * @param policy a parsed policy.
+   * @param node a parsed node for the kBind policy, which must be available for allocation.
+   * @retval true if the string is valid.
+   * @retval false otherwise.
+   */
+  static bool
+  Parse(  //
+      const std::string &str,
+      NUMAPolicy &policy,
+      int &node)
+  {
+    const std::string kBindPrefix = "bind:";
+
+    node = 0;
+    if (str == "default") {
+      policy = kDefaultPolicy;
+    } else if (str == "local") {
+      policy = kLocal;
+    } else if (str == "interleave") {
+      policy = kInterleave;
+    } else if (str == "first_touch") {
+      policy = kFirstTouch;
+    } else if (str.compare(0, kBindPrefix.size(), kBindPrefix) == 0) {
+      const auto node_str = str.substr(kBindPrefix.size());
+      if (node_str.empty() || node_str.find_first_not_of("0123456789") != std::string::npos
+          || node_str.size() > std::to_string(GetMaxNode()).size()) {
+        return false;
+      }
+      node = std::stoi(node_str);
+      if (!IsAvailableNode(node)) return false;
+      policy = kBind;
+    } else {
+      return false;
+    }
+    return true;
+  }
+
+ private:
+  /*################################################################################################
+   * Internal member variables
+   *##############################################################################################*/
+
+  /// a placement policy of target fields
+  NUMAPolicy policy_;
+
+  /// a node for the kBind policy
+  int bind_node_;
+
+  /// a flag to pin worker threads to CPUs
+  bool pin_workers_;
+
+  /// a flag to indicate libnuma is available
+  bool numa_enabled_;
+
+  /// available CPUs in node-major order
+  std::vector<int> cpus_{};
+
+  /// the head address of target fields
+  uintptr_t region_head_{0};
+
+  /// the size of a page in bytes
+  size_t page_size_{1};
+
+  /// the NUMA node of each page in target fields
+  std::vector<uint8_t> page_nodes_{};
+
+  /// a flag to indicate a calling thread has been pinned
+  static inline thread_local bool thread_pinned_{false};
+};
+
+#endif  // MWCAS_BENCHMARK_NUMA_PLACEMENT_H
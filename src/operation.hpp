@@ -21,7 +21,75 @@
 #include <array>
 
 #include "common.hpp"
+#include "sorting_network.hpp"
+#include "target_fields.hpp"
 
+/*##################################################################################################
+ * Global enums
+ *################################################################################################*/
+
+/**
+ * @brief Types of benchmark operations.
+ *
+ */
+enum OperationType : uint8_t
+{
+  /// update target words with an MwCAS operation
+  kUpdate,
+  /// read target words with an MwCAS-aware read procedure
+  kRead,
+};
+
+/// the number of operation types
+constexpr size_t kOperationTypeNum = 2;
+
+/**
+ * @param type an operation type.
+ * @return the name of the type.
+ */
+constexpr const char *
+ToString(const OperationType type)
+{
+  return (type == kRead) ? "read" : "update";
+}
+
+/*##################################################################################################
+ * Global utility functions
+ *################################################################################################*/
+
+/**
+ * @brief Sort the first elements of an array by insertion sort.
+ *
+ * Loops are bounded by kTargetNum as well, so that compilers can prove that every access is
+ * within the array (std::sort over a runtime prefix raises -Warray-bounds).
+ *
+ * @tparam T the class of elements.
+ * @param elements elements to be sorted.
+ * @param n the number of elements to be sorted.
+ */
+template <class T>
+void
+SortPrefix(  //
+    std::array<T, kTargetNum> &elements,
+    const size_t n)
+{
+  for (size_t i = 1; i < n && i < kTargetNum; ++i) {
+    const auto elem = elements[i];
+    auto j = i;
+    for (; j > 0 && elements[j - 1] > elem; --j) {
+      elements[j] = elements[j - 1];
+    }
+    elements[j] = elem;
+  }
+}
+
+/**
+ * @brief An operation that holds the addresses of target words.
+ *
+ * The width and type of an operation are packed into the unused upper bits of its first
+ * target address (user-space addresses fit in 48 bits), so that an operation is as large as
+ * its target addresses and replaying queues does not consume extra bandwidth.
+ */
 class Operation
 {
  public:
@@ -29,7 +97,18 @@ class Operation
    * Public constructors and assignment operators
    *##############################################################################################*/
 
-  constexpr Operation() : targets_{} {}
+  constexpr Operation() : targets_{} { targets_[0] = Pack(kTargetNum, kUpdate); }
+
+  Operation(  //
+      const std::array<uint64_t *, kTargetNum> &targets,
+      const size_t width,
+      const OperationType type)
+  {
+    for (size_t i = 0; i < kTargetNum; ++i) {
+      targets_[i] = reinterpret_cast<uintptr_t>(targets[i]);
+    }
+    targets_[0] |= Pack(width, type);
+  }
 
   constexpr Operation(const Operation &) = default;
   constexpr Operation &operator=(const Operation &obj) = default;
@@ -46,10 +125,40 @@ class Operation
    * Public getters/setters
    *##############################################################################################*/
 
-  constexpr uint64_t *
+  uint64_t *
   GetAddr(const size_t i) const
   {
-    return targets_[i];
+    return reinterpret_cast<uint64_t *>(targets_[i] & kAddrMask);
+  }
+
+  /**
+   * @return the number of active target words.
+   */
+  constexpr size_t
+  GetWidth() const
+  {
+    return (targets_[0] >> kWidthShift) & kWidthMask;
+  }
+
+  /**
+   * @param width the number of active target words (at most kTargetNum).
+   */
+  void
+  SetWidth(const size_t width)
+  {
+    targets_[0] = (targets_[0] & ~(kWidthMask << kWidthShift)) | (width << kWidthShift);
+  }
+
+  constexpr OperationType
+  GetType() const
+  {
+    return static_cast<OperationType>(targets_[0] >> kTypeShift);
+  }
+
+  void
+  SetType(const OperationType type)
+  {
+    targets_[0] = (targets_[0] & ~(kTypeMask << kTypeShift)) | (uintptr_t{type} << kTypeShift);
   }
 
   bool
@@ -58,13 +167,28 @@ class Operation
       uint64_t *addr)
   {
     // check the target address has been already set
-    const auto cur_end = targets_.begin() + i;
-    if (std::find(targets_.begin(), cur_end, addr) != cur_end) return false;
+    for (size_t j = 0; j < i; ++j) {
+      if (GetAddr(j) == addr) return false;
+    }
 
-    targets_[i] = addr;
+    SetDistinctAddr(i, addr);
     return true;
   }
 
+  /**
+   * @brief Set a target address without checking duplicates.
+   *
+   * @param i the position of a target word.
+   * @param addr a target address that a caller has confirmed as distinct.
+   */
+  void
+  SetDistinctAddr(  //
+      const size_t i,
+      uint64_t *addr)
+  {
+    targets_[i] = (targets_[i] & ~kAddrMask) | reinterpret_cast<uintptr_t>(addr);
+  }
+
   /*################################################################################################
    * Public utility functions
    *##############################################################################################*/
@@ -72,11 +196,210 @@ class Operation
   /**
    * @brief Sort target addresses to linearize MwCAS operations.
    *
+   * Full-width operations are sorted by a sorting network to avoid branch mispredictions.
+   */
+  void
+  SortTargets()
+  {
+    // detach packed fields so that only addresses are compared
+    const auto meta = targets_[0] & ~kAddrMask;
+    targets_[0] &= kAddrMask;
+    if (GetWidthOf(meta) == kTargetNum) {
+      SortingNetwork<kTargetNum>::Sort(targets_);
+    } else {
+      SortPrefix(targets_, GetWidthOf(meta));
+    }
+    targets_[0] |= meta;
+  }
+
+ private:
+  /*################################################################################################
+   * Internal constants
+   *##############################################################################################*/
+
+  /// the position of a width in the first target
+  static constexpr size_t kWidthShift = 48;
+
+  /// a mask to extract a width after shifting
+  static constexpr uintptr_t kWidthMask = 0xFF;
+
+  /// the position of a type in the first target
+  static constexpr size_t kTypeShift = 56;
+
+  /// a mask to extract a type after shifting
+  static constexpr uintptr_t kTypeMask = 0xFF;
+
+  /// a mask to extract an address from a target
+  static constexpr uintptr_t kAddrMask = (uintptr_t{1} << kWidthShift) - 1;
+
+  static_assert(kTargetNum <= kWidthMask);
+
+  /*################################################################################################
+   * Internal utility functions
+   *##############################################################################################*/
+
+  /**
+   * @param width the number of active target words.
+   * @param type the type of an operation.
+   * @return the packed fields to be embedded in the first target.
+   */
+  static constexpr uintptr_t
+  Pack(  //
+      const size_t width,
+      const OperationType type)
+  {
+    return (width << kWidthShift) | (uintptr_t{type} << kTypeShift);
+  }
+
+  /**
+   * @param meta the packed fields of the first target.
+   * @return the number of active target words.
+   */
+  static constexpr size_t
+  GetWidthOf(const uintptr_t meta)
+  {
+    return (meta >> kWidthShift) & kWidthMask;
+  }
+
+  /*################################################################################################
+   * Internal member variables
+   *##############################################################################################*/
+
+  /// target addresses of an MwCAS operation (the first one also holds a width and a type)
+  std::array<uintptr_t, kTargetNum> targets_;
+};
+
+/**
+ * @brief A compact operation that holds the indices of target fields instead of addresses.
+ *
+ * This representation halves the footprint of operation queues (and so the bandwidth to replay
+ * them), and target addresses are decoded with target fields just before execution.
+ */
+class CompactOperation
+{
+ public:
+  /*################################################################################################
+   * Type aliases
+   *##############################################################################################*/
+
+  using Index_t = uint32_t;
+
+  /*################################################################################################
+   * Public constructors and assignment operators
+   *##############################################################################################*/
+
+  constexpr CompactOperation() : indices_{} {}
+
+  constexpr CompactOperation(const CompactOperation &) = default;
+  constexpr CompactOperation &operator=(const CompactOperation &obj) = default;
+  constexpr CompactOperation(CompactOperation &&) = default;
+  constexpr CompactOperation &operator=(CompactOperation &&) = default;
+
+  /*################################################################################################
+   * Public destructors
+   *##############################################################################################*/
+
+  ~CompactOperation() = default;
+
+  /*################################################################################################
+   * Public getters/setters
+   *##############################################################################################*/
+
+  constexpr Index_t
+  GetIndex(const size_t i) const
+  {
+    return indices_[i];
+  }
+
+  /**
+   * @return the number of active target words.
+   */
+  constexpr size_t
+  GetWidth() const
+  {
+    return width_;
+  }
+
+  /**
+   * @param width the number of active target words (at most kTargetNum).
+   */
+  void
+  SetWidth(const size_t width)
+  {
+    width_ = static_cast<uint8_t>(width);
+  }
+
+  constexpr OperationType
+  GetType() const
+  {
+    return type_;
+  }
+
+  void
+  SetType(const OperationType type)
+  {
+    type_ = type;
+  }
+
+  bool
+  SetIndex(  //
+      const size_t i,
+      const Index_t index)
+  {
+    // check the target index has been already set
+    const auto cur_end = indices_.begin() + i;
+    if (std::find(indices_.begin(), cur_end, index) != cur_end) return false;
+
+    indices_[i] = index;
+    return true;
+  }
+
+  /**
+   * @brief Set a target index without checking duplicates.
+   *
+   * @param i the position of a target word.
+   * @param index a target index that a caller has confirmed as distinct.
+   */
+  void
+  SetDistinctIndex(  //
+      const size_t i,
+      const Index_t index)
+  {
+    indices_[i] = index;
+  }
+
+  /*################################################################################################
+   * Public utility functions
+   *##############################################################################################*/
+
+  /**
+   * @brief Sort target indices to linearize MwCAS operations.
+   *
+   * Since target fields are placed in ascending order, sorted indices are decoded into
+   * sorted addresses. Full-width operations are sorted by a sorting network as well.
    */
   void
   SortTargets()
   {
-    std::sort(targets_.begin(), targets_.end());
+    if (width_ == kTargetNum) {
+      SortingNetwork<kTargetNum>::Sort(indices_);
+    } else {
+      SortPrefix(indices_, width_);
+    }
+  }
+
+  /**
+   * @param target_fields target fields that the indices refer to.
+   * @return an operation with decoded target addresses.
+   */
+  Operation
+  Decode(const TargetFields &target_fields) const
+  {
+    std::array<uint64_t *, kTargetNum> targets{};
+    for (size_t i = 0; i < width_; ++i) {
+      targets[i] = target_fields[indices_[i]];
+    }
+    return Operation{targets, width_, type_};
   }
 
  private:
@@ -84,8 +407,25 @@ class Operation
    * Internal member variables
    *##############################################################################################*/
 
-  /// target addresses of an MwCAS operation
-  std::array<uint64_t *, kTargetNum> targets_;
+  /// the indices of target fields
+  std::array<Index_t, kTargetNum> indices_;
+
+  /// the number of active target words
+  uint8_t width_{kTargetNum};
+
+  /// the type of this operation
+  OperationType type_{kUpdate};
 };
 
+/*##################################################################################################
+ * Global type aliases
+ *################################################################################################*/
+
+/// the representation of operations in operation queues
+#ifdef MWCAS_BENCH_COMPACT_OPERATION
+using QueuedOperation = CompactOperation;
+#else
+using QueuedOperation = Operation;
+#endif
+
 #endif  // MWCAS_BENCHMARK_OPERATION_H
@@ -17,13 +17,46 @@
 #ifndef MWCAS_BENCHMARK_OPERATION_ENGINE_H
 #define MWCAS_BENCHMARK_OPERATION_ENGINE_H
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <numeric>
+#include <memory>
 #include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
 #include "common.hpp"
+#include "key_distribution.hpp"
+#include "memory_region.hpp"
+#include "numa_placement.hpp"
 #include "operation.hpp"
-#include "random/zipf.hpp"
+#include "report.hpp"
+#include "target_fields.hpp"
+#include "target_set.hpp"
+#include "width_distribution.hpp"
+
+/*##################################################################################################
+ * Global enums
+ *################################################################################################*/
+
+/**
+ * @brief Mappings from the ranks of a key distribution to target fields.
+ *
+ */
+enum KeyLayout
+{
+  /// map ranks to fields in allocation order (i.e., hot fields are adjacent)
+  kClustered,
+  /// map ranks to fields via a random permutation
+  kScattered,
+  /// map consecutive ranks to fields in different pages
+  kPageSpread,
+};
 
 class OperationEngine
 {
@@ -31,18 +64,45 @@ class OperationEngine
    * Type aliases
    *##############################################################################################*/
 
-  using ZipfGenerator = ::dbgroup::random::zipf::ZipfGenerator;
+  using Clock_t = ::std::chrono::high_resolution_clock;
 
  public:
+  /*################################################################################################
+   * Public type aliases
+   *##############################################################################################*/
+
+  /// per-worker operation queues in index form
+  using Workload_t = std::vector<std::vector<CompactOperation>>;
+
   /*################################################################################################
    * Public constructors and assignment operators
    *##############################################################################################*/
 
   OperationEngine(  //
-      const std::vector<uint64_t *> &target_fields,
-      const double skew_parameter)
-      : target_fields_{target_fields}, zipf_engine_{target_fields_.size(), skew_parameter}
+      const TargetFields &target_fields,
+      const KeyDistribution &key_dist,
+      const WidthDistribution &width_dist,
+      const double read_ratio,
+      const KeyLayout key_layout,
+      const size_t layout_seed,
+      const HugePageMode huge_page_mode,
+      const NUMAPlacement &placement,
+      const bool presort = true)
+      : target_fields_{target_fields},
+        key_dist_{key_dist},
+        width_dist_{width_dist},
+        read_ratio_{read_ratio},
+        presort_{presort},
+        huge_page_mode_{huge_page_mode},
+        placement_{placement}
   {
+    if (key_layout == kScattered) {
+      slots_.resize(target_fields_.size());
+      std::iota(slots_.begin(), slots_.end(), 0);
+      std::shuffle(slots_.begin(), slots_.end(), std::mt19937_64{layout_seed});
+    } else if (key_layout == kPageSpread) {
+      PrepareSpreadSlots(layout_seed);
+    }
   }
 
   OperationEngine(const OperationEngine &) = default;
@@ -60,41 +120,459 @@ class OperationEngine
    * Public utility functions
    *##############################################################################################*/
 
-  std::vector<Operation>
+  /**
+   * @brief Generate an operation queue for a calling worker thread.
+   *
+   * If worker threads are pinned, a calling thread is pinned before generation (unless it has
+   * been already pinned) and its queue is allocated on its own node. Since each worker calls
+   * this function with its own seed, queues are generated in parallel and deterministically.
+   *
+   * If a workload is set, a calling thread claims an unclaimed prepared queue of the requested
+   * size instead, because threads may call this function in any order.
+   *
+   * @param n the number of operations to be generated.
+   * @param random_seed a random seed for a calling worker.
+   * @return generated operations.
+   */
+  std::vector<QueuedOperation>
   Generate(  //
       const size_t n,
       const size_t random_seed)
   {
+    if (workload_ != nullptr) return Generate(n, random_seed, ClaimPreparedQueue(n));
+    return Generate(n, random_seed, gen_worker_num_.fetch_add(1, std::memory_order_relaxed));
+  }
+
+  /**
+   * @brief Generate an operation queue for a given worker.
+   *
+   * @param n the number of operations to be generated.
+   * @param random_seed a random seed for the worker.
+   * @param worker_id the ID of the worker.
+   * @return generated operations.
+   */
+  std::vector<QueuedOperation>
+  Generate(  //
+      const size_t n,
+      const size_t random_seed,
+      const size_t worker_id)
+  {
+    if (placement_.PinWorkers() && !NUMAPlacement::IsThreadPinned()) {
+      placement_.PinThread(worker_id);
+    }
+
+    const auto start_time = Clock_t::now();
     std::mt19937_64 rand_engine{random_seed};
 
     // generate an operation-queue for benchmarking
-    std::vector<Operation> operations;
+    std::vector<QueuedOperation> operations;
     operations.reserve(n);
+    if (placement_.PinWorkers()) {
+      placement_.BindLocalMemory(operations.data(), n * sizeof(QueuedOperation));
+    }
+    if (huge_page_mode_ != kNoHugePage) {
+      // hugetlbfs cannot be used via std::allocator, so operation queues always use THP
+      MemoryRegion::Advise(operations.data(), n * sizeof(QueuedOperation));
+    }
+    const auto *prepared = GetPreparedQueue(n, worker_id);
+    if (workload_ != nullptr && prepared == nullptr) {
+      throw std::runtime_error{"no prepared queue of " + std::to_string(n) + " operations for "
+                               + "worker " + std::to_string(worker_id)};
+    }
     for (size_t i = 0; i < n; ++i) {
-      // select target addresses for i-th operation
-      Operation ops{};
-      for (size_t j = 0; j < kTargetNum; ++j) {
-        auto addr = target_fields_[zipf_engine_(rand_engine)];
-        while (!ops.SetAddr(j, addr)) addr = target_fields_[zipf_engine_(rand_engine)];
+      if (prepared == nullptr) {
+        operations.emplace_back(GenerateOperation(rand_engine, worker_id, i));
+      } else {
+        operations.emplace_back(Restore((*prepared)[i]));
       }
-      ops.SortTargets();
+    }
 
-      operations.emplace_back(std::move(ops));
+    // record generation time for reporting setup costs
+    const auto gen_time = Clock_t::now() - start_time;
+    const size_t gen_nano = std::chrono::duration_cast<std::chrono::nanoseconds>(gen_time).count();
+    gen_nano_sum_.fetch_add(gen_nano, std::memory_order_relaxed);
+    auto max_nano = gen_nano_max_.load(std::memory_order_relaxed);
+    while (max_nano < gen_nano) {
+      if (gen_nano_max_.compare_exchange_weak(max_nano, gen_nano, std::memory_order_relaxed)) break;
+    }
+
+    if (huge_page_mode_ != kNoHugePage) {
+      const auto size = n * sizeof(QueuedOperation);
+      queue_bytes_.fetch_add(size, std::memory_order_relaxed);
+      queue_huge_bytes_.fetch_add(MemoryRegion::CountHugePageBytes(operations.data(), size),
+                                  std::memory_order_relaxed);
     }
 
     return operations;
   }
 
+  /**
+   * @brief Generate operations into a given buffer without recording any statistics.
+   *
+   * This function is used to generate operations on the fly in small batches, and so it
+   * does not allocate any memory.
+   *
+   * @tparam RandEngine the class of a random engine.
+   * @param n the number of operations to be generated.
+   * @param rand_engine a random engine of a calling thread.
+   * @param worker_id the ID of a calling worker.
+   * @param op_offset the number of operations generated by the worker so far.
+   * @param batch a buffer to store generated operations.
+   */
+  template <class RandEngine>
+  void
+  GenerateBatch(  //
+      const size_t n,
+      RandEngine &rand_engine,
+      const size_t worker_id,
+      const size_t op_offset,
+      QueuedOperation *batch)
+  {
+    for (size_t i = 0; i < n; ++i) {
+      batch[i] = GenerateOperation(rand_engine, worker_id, op_offset + i);
+    }
+  }
+
+  /**
+   * @brief Generate per-worker operation queues in index form.
+   *
+   * The i-th queue has the same operations as the queue of the i-th worker generated with the
+   * i-th seed drawn from a base seed. Since indices do not depend on the addresses of target
+   * fields, a workload can be replayed against any fields with the same number of fields.
+   *
+   * @param n the total number of operations.
+   * @param worker_num the number of workers.
+   * @param random_seed a base random seed.
+   * @return generated queues.
+   */
+  Workload_t
+  GenerateWorkload(  //
+      const size_t n,
+      const size_t worker_num,
+      const size_t random_seed)
+  {
+    Workload_t workload(worker_num);
+    std::mt19937_64 seed_engine{random_seed};
+
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < worker_num; ++i) {
+      threads.emplace_back([&, i, seed = seed_engine()] {
+        std::mt19937_64 rand_engine{seed};
+        const auto worker_op_num = (n + i) / worker_num;
+        workload[i].reserve(worker_op_num);
+        for (size_t j = 0; j < worker_op_num; ++j) {
+          workload[i].emplace_back(GenerateOperation<CompactOperation>(rand_engine, i, j));
+        }
+      });
+    }
+    for (auto &&t : threads) t.join();
+
+    return workload;
+  }
+
+  /**
+   * @brief Replay a prepared workload in subsequent calls of Generate.
+   *
+   * The i-th worker receives the i-th queue of the workload, and workers without IDs claim
+   * queues of their sizes. Since every implementation must replay the same workload, a
+   * request that no queue can satisfy is an error rather than a fallback to generation.
+   *
+   * @param workload a workload prepared by GenerateWorkload (or nullptr to generate queues).
+   */
+  void
+  SetWorkload(const Workload_t *workload)
+  {
+    workload_ = workload;
+    const auto queue_num = (workload == nullptr) ? 0 : workload->size();
+    claimed_ = std::make_unique<std::atomic_bool[]>(queue_num);
+    for (size_t i = 0; i < queue_num; ++i) {
+      claimed_[i].store(false, std::memory_order_relaxed);
+    }
+  }
+
+  /**
+   * @return the longest time to generate one operation queue in seconds.
+   */
+  double
+  GetGenerationTime() const
+  {
+    return gen_nano_max_.load(std::memory_order_relaxed) / 1E9;
+  }
+
+  /**
+   * @return the total time to generate all the operation queues in seconds.
+   */
+  double
+  GetTotalGenerationTime() const
+  {
+    return gen_nano_sum_.load(std::memory_order_relaxed) / 1E9;
+  }
+
+  /**
+   * @brief Reset the statistics of generated operation queues (e.g., after warming up).
+   *
+   */
+  void
+  ResetStats()
+  {
+    gen_worker_num_.store(0, std::memory_order_relaxed);
+    gen_nano_max_.store(0, std::memory_order_relaxed);
+    gen_nano_sum_.store(0, std::memory_order_relaxed);
+    queue_bytes_.store(0, std::memory_order_relaxed);
+    queue_huge_bytes_.store(0, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Add how much of operation queues are backed by huge pages to a report.
+   *
+   * Queues may share heap mappings with other data, so the huge-page size is approximate
+   * (see MemoryRegion::CountHugePageBytes).
+   *
+   * @param report a report to add results.
+   */
+  void
+  ReportHugePages(Report &report) const
+  {
+    if (huge_page_mode_ == kNoHugePage) return;
+
+    constexpr double kMiB = 1UL << 20UL;
+    report.Add("huge pages", "operation queues mode", "thp");
+    report.Add("huge pages", "operation queues [MiB]", queue_bytes_.load() / kMiB);
+    report.Add("huge pages", "operation queues on huge pages (approx.) [MiB]",
+               queue_huge_bytes_.load() / kMiB);
+  }
+
+  /*################################################################################################
+   * Public static utilities
+   *##############################################################################################*/
+
+  /**
+   * @brief Parse a key layout string.
+   *
+   * @param str a layout string ("clustered", "scattered", or "page_spread").
+   * @param layout a parsed layout.
+   * @retval true if the string is valid.
+   * @retval false otherwise.
+   */
+  static bool
+  Parse(  //
+      const std::string &str,
+      KeyLayout &layout)
+  {
+    if (str == "clustered") {
+      layout = kClustered;
+    } else if (str == "scattered") {
+      layout = kScattered;
+    } else if (str == "page_spread") {
+      layout = kPageSpread;
+    } else {
+      return false;
+    }
+    return true;
+  }
+
  private:
+  /*################################################################################################
+   * Internal utility functions
+   *##############################################################################################*/
+
+  /**
+   * @tparam Op the class of an operation to be generated.
+   * @tparam RandEngine the class of a random engine.
+   * @param rand_engine a random engine of a calling thread.
+   * @param worker_id the ID of a calling worker.
+   * @param op_id the sequential number of an operation in the worker.
+   * @return an operation with distinct (and sorted if requested) targets.
+   */
+  template <class Op = QueuedOperation, class RandEngine>
+  Op
+  GenerateOperation(  //
+      RandEngine &rand_engine,
+      const size_t worker_id,
+      const size_t op_id)
+  {
+    Op ops{};
+    ops.SetWidth(width_dist_(rand_engine));
+    if (read_ratio_ > 0) {
+      const auto u = std::uniform_real_distribution<double>{0, 1}(rand_engine);
+      if (u < read_ratio_) ops.SetType(kRead);
+    }
+    const auto op_draw = key_dist_.DrawOperation(rand_engine);
+    TargetSet selected{};
+    for (size_t j = 0; j < ops.GetWidth(); ++j) {
+      size_t slot{};
+      do {  // retry until a distinct field is selected
+        slot = GetSlot(key_dist_(rand_engine, worker_id, op_id, op_draw));
+      } while (!selected.Insert(slot));
+      SetTarget(ops, j, slot);
+    }
+    if (presort_) ops.SortTargets();
+
+    return ops;
+  }
+
+  /**
+   * @param n the number of requested operations.
+   * @return the ID of a worker whose prepared queue has the size and has been claimed now.
+   */
+  size_t
+  ClaimPreparedQueue(const size_t n)
+  {
+    for (size_t i = 0; i < workload_->size(); ++i) {
+      if ((*workload_)[i].size() != n || claimed_[i].load(std::memory_order_relaxed)) continue;
+      if (!claimed_[i].exchange(true, std::memory_order_relaxed)) return i;
+    }
+    throw std::runtime_error{"no unclaimed prepared queue of " + std::to_string(n)
+                             + " operations"};
+  }
+
+  /**
+   * @param n the number of requested operations.
+   * @param worker_id the ID of a calling worker.
+   * @return the prepared queue of the worker (or nullptr if it is not available).
+   */
+  const std::vector<CompactOperation> *
+  GetPreparedQueue(  //
+      const size_t n,
+      const size_t worker_id) const
+  {
+    if (workload_ == nullptr || worker_id >= workload_->size()) return nullptr;
+
+    const auto &queue = (*workload_)[worker_id];
+    return (queue.size() == n) ? &queue : nullptr;
+  }
+
+  /**
+   * @tparam Op the class of queued operations.
+   * @param ops an operation of a prepared workload.
+   * @return the operation to be queued.
+   */
+  template <class Op = QueuedOperation>
+  Op
+  Restore(const CompactOperation &ops) const
+  {
+    if constexpr (std::is_same_v<Op, CompactOperation>) {
+      return ops;
+    } else {
+      return ops.Decode(target_fields_);
+    }
+  }
+
+  /**
+   * @brief Set the j-th target of an operation with the address of a distinct field.
+   *
+   */
+  void
+  SetTarget(  //
+      Operation &ops,
+      const size_t j,
+      const size_t slot) const
+  {
+    ops.SetDistinctAddr(j, target_fields_[slot]);
+  }
+
+  /**
+   * @brief Set the j-th target of a compact operation with the index of a distinct field.
+   *
+   */
+  void
+  SetTarget(  //
+      CompactOperation &ops,
+      const size_t j,
+      const size_t slot) const
+  {
+    ops.SetDistinctIndex(j, static_cast<CompactOperation::Index_t>(slot));
+  }
+
+  /**
+   * @param rank the rank of a key distribution.
+   * @return the index of a target field for the rank.
+   */
+  size_t
+  GetSlot(const size_t rank) const
+  {
+    return (slots_.empty()) ? rank : slots_[rank];
+  }
+
+  /**
+   * @brief Prepare slots so that consecutive ranks are assigned to different pages.
+   *
+   * Ranks are assigned to pages in round-robin order, where pages are shuffled with a given
+   * seed. Thus, the hottest keys do not share pages until every page has one of them.
+   *
+   * @param layout_seed a random seed to shuffle pages.
+   */
+  void
+  PrepareSpreadSlots(const size_t layout_seed)
+  {
+    const auto page_size = (target_fields_.GetHugePageMode() == kNoHugePage)
+                               ? static_cast<size_t>(sysconf(_SC_PAGESIZE))
+                               : kHugePageSize;
+    const auto field_num = target_fields_.size();
+    const auto fields_per_page = std::max<size_t>(page_size / target_fields_.GetStride(), 1);
+    const auto page_num = (field_num + fields_per_page - 1) / fields_per_page;
+
+    std::vector<size_t> pages(page_num);
+    std::iota(pages.begin(), pages.end(), 0);
+    std::shuffle(pages.begin(), pages.end(), std::mt19937_64{layout_seed});
+
+    slots_.reserve(field_num);
+    for (size_t i = 0; i < fields_per_page; ++i) {
+      for (auto &&page : pages) {
+        const auto slot = page * fields_per_page + i;
+        if (slot < field_num) slots_.emplace_back(slot);
+      }
+    }
+  }
+
   /*################################################################################################
    * Internal member variables
    *##############################################################################################*/
 
   /// a reference to MwCAS target fields
-  const std::vector<uint64_t *> &target_fields_;
+  const TargetFields &target_fields_;
+
+  /// a permutation from ranks to target fields (empty if ranks are used as they are)
+  std::vector<size_t> slots_{};
+
+  /// a distribution to select the ranks of target fields
+  KeyDistribution key_dist_;
+
+  /// a distribution to select the number of target words of each operation
+  WidthDistribution width_dist_;
+
+  /// the ratio of read operations
+  double read_ratio_;
+
+  /// a flag to sort targets in generation (otherwise workers sort them in measurement)
+  bool presort_;
+
+  /// a requested backing mode of operation queues
+  HugePageMode huge_page_mode_;
+
+  /// placement of worker threads
+  const NUMAPlacement &placement_;
+
+  /// a prepared workload to be replayed (nullptr if queues are generated)
+  const Workload_t *workload_{nullptr};
+
+  /// flags indicating that the queues of a prepared workload have been claimed by workers
+  std::unique_ptr<std::atomic_bool[]> claimed_{};
+
+  /// the number of worker threads pinned for generation
+  std::atomic_size_t gen_worker_num_{0};
+
+  /// the longest time to generate one operation queue in nanoseconds
+  std::atomic_size_t gen_nano_max_{0};
+
+  /// the total time to generate operation queues in nanoseconds
+  std::atomic_size_t gen_nano_sum_{0};
+
+  /// the total size of generated operation queues
+  std::atomic_size_t queue_bytes_{0};
 
-  /// a random engine according to Zipf's law
-  ZipfGenerator zipf_engine_;
+  /// the total size of generated operation queues on huge pages
+  std::atomic_size_t queue_huge_bytes_{0};
 };
 
 #endif  // MWCAS_BENCHMARK_OPERATION_ENGINE_H
@@ -0,0 +1,522 @@
+/*
+ * Copyright 2021 Database Group, Nagoya University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MWCAS_BENCHMARK_OPERATION_TRACE_H
+#define MWCAS_BENCHMARK_OPERATION_TRACE_H
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "common.hpp"
+#include "operation.hpp"
+#include "target_fields.hpp"
+
+/*##################################################################################################
+ * Global constants
+ *################################################################################################*/
+
+/// the magic number at the head of trace files ("MWCTRACE" in little endian)
+constexpr uint64_t kTraceMagic = 0x454341525443574DUL;
+
+/// the version of the trace format
+constexpr uint32_t kTraceVersion = 1;
+
+/**
+ * @brief The header of trace files.
+ *
+ */
+struct TraceHeader {
+  /// the magic number of trace files
+  uint64_t magic;
+
+  /// the version of the trace format
+  uint32_t version;
+
+  /// the number of index slots in each record (i.e., the maximum width)
+  uint32_t max_width;
+
+  /// the number of target fields that indices refer to
+  uint64_t field_num;
+
+  /// the number of operations
+  uint64_t op_num;
+};
+
+/**
+ * @brief A memory-mapped trace of MwCAS operations.
+ *
+ * A trace file consists of a header and fixed-size records in native byte order. Each record
+ * has a 32-bit word (a width in the low 16 bits and an operation type in the next bits) and
+ * `max_width` 32-bit indices of target fields, where indices beyond the width are ignored.
+ * Since records have a fixed size, workers can replay any part of a trace directly from a
+ * mapping without scanning preceding records. Captured traces may leave types zero (updates).
+ */
+class OperationTrace
+{
+ public:
+  /*################################################################################################
+   * Type aliases
+   *##############################################################################################*/
+
+  /// the type of words in trace records
+  using Word_t = uint32_t;
+
+  /*################################################################################################
+   * Public constructors and assignment operators
+   *##############################################################################################*/
+
+  /**
+   * @brief Map a trace file and verify every record.
+   *
+   * Pages are populated in advance to keep page faults on a trace out of measurement.
+   *
+   * @param path the path of a trace file.
+   */
+  explicit OperationTrace(const std::string &path)
+  {
+    const auto fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+      error_ = "cannot open " + path;
+      return;
+    }
+
+    struct stat file_stat {};
+    const auto has_header = fstat(fd, &file_stat) == 0
+                            && static_cast<size_t>(file_stat.st_size) >= sizeof(TraceHeader);
+    if (has_header) {
+      map_size_ = file_stat.st_size;
+      map_head_ = mmap(nullptr, map_size_, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0);
+    }
+    close(fd);
+
+    if (map_head_ == MAP_FAILED) {
+      error_ = (map_size_ == 0) ? path + " is too short" : "cannot map " + path;
+      return;
+    }
+    error_ = Verify();
+  }
+
+  OperationTrace(const OperationTrace &) = delete;
+  OperationTrace &operator=(const OperationTrace &obj) = delete;
+  OperationTrace(OperationTrace &&) = delete;
+  OperationTrace &operator=(OperationTrace &&) = delete;
+
+  /*################################################################################################
+   * Public destructors
+   *##############################################################################################*/
+
+  ~OperationTrace()
+  {
+    if (map_head_ != MAP_FAILED) munmap(map_head_, map_size_);
+  }
+
+  /*################################################################################################
+   * Public getters
+   *##############################################################################################*/
+
+  /**
+   * @retval true if a trace has been mapped and verified.
+   * @retval false otherwise.
+   */
+  bool
+  IsValid() const
+  {
+    return error_.empty();
+  }
+
+  /**
+   * @return the reason why a trace is invalid.
+   */
+  const std::string &
+  GetError() const
+  {
+    return error_;
+  }
+
+  /**
+   * @return the number of target fields that a trace refers to.
+   */
+  size_t
+  GetFieldNum() const
+  {
+    return header_.field_num;
+  }
+
+  /**
+   * @return the number of operations in a trace.
+   */
+  size_t
+  GetOpNum() const
+  {
+    return header_.op_num;
+  }
+
+  /**
+   * @return the size of a trace file in bytes.
+   */
+  size_t
+  size() const
+  {
+    return map_size_;
+  }
+
+  /**
+   * @retval true if a trace includes read operations.
+   * @retval false otherwise.
+   */
+  bool
+  HasReads() const
+  {
+    return has_reads_;
+  }
+
+  /**
+   * @retval true if operations in a trace have various widths.
+   * @retval false otherwise.
+   */
+  bool
+  HasVariableWidths() const
+  {
+    return has_variable_widths_;
+  }
+
+  /*################################################################################################
+   * Public utility functions
+   *##############################################################################################*/
+
+  /**
+   * @brief Read the i-th record as an operation with sorted targets.
+   *
+   * @param i the position of a record.
+   * @param ops an output operation.
+   * @retval true if the record is valid.
+   * @retval false otherwise.
+   */
+  bool
+  Read(  //
+      const size_t i,
+      CompactOperation &ops) const
+  {
+    const auto *record = records_ + i * record_words_;
+    const size_t width = record[0] & kWidthMask;
+    const size_t type = record[0] >> kTypeShift;
+    if (width == 0 || width > std::min<size_t>(header_.max_width, kTargetNum)) return false;
+    if (type >= kOperationTypeNum) return false;
+
+    ops.SetWidth(width);
+    ops.SetType(static_cast<OperationType>(type));
+    for (size_t j = 0; j < width; ++j) {
+      const auto index = record[j + 1];
+      if (index >= header_.field_num || !ops.SetIndex(j, index)) return false;
+    }
+    ops.SortTargets();
+    return true;
+  }
+
+  /**
+   * @brief Read the i-th record of a verified trace without checking it again.
+   *
+   * Every record has been checked when a trace was opened, so this function only copies the
+   * words of a record. Targets are sorted only if requested and a trace has unsorted records.
+   *
+   * @param i the position of a record.
+   * @param sort a flag to sort targets.
+   * @param ops an output operation.
+   */
+  void
+  ReadVerified(  //
+      const size_t i,
+      const bool sort,
+      CompactOperation &ops) const
+  {
+    const auto *record = records_ + i * record_words_;
+    const size_t width = record[0] & kWidthMask;
+    ops.SetWidth(width);
+    ops.SetType(static_cast<OperationType>(record[0] >> kTypeShift));
+    for (size_t j = 0; j < width; ++j) {
+      ops.SetDistinctIndex(j, record[j + 1]);
+    }
+    if (sort && has_unsorted_records_) ops.SortTargets();
+  }
+
+  /*################################################################################################
+   * Public static utilities
+   *##############################################################################################*/
+
+  /**
+   * @brief Write per-worker operation queues to a trace file in worker order.
+   *
+   * @param path the path of a trace file.
+   * @param field_num the number of target fields that indices refer to.
+   * @param queues per-worker operation queues.
+   * @retval true if all the operations have been written.
+   * @retval false otherwise.
+   */
+  static bool
+  Write(  //
+      const std::string &path,
+      const size_t field_num,
+      const std::vector<std::vector<CompactOperation>> &queues)
+  {
+    std::ofstream out{path, std::ios::binary | std::ios::trunc};
+    if (!out) return false;
+
+    size_t op_num = 0;
+    for (auto &&queue : queues) {
+      op_num += queue.size();
+    }
+    WriteHeader(out, field_num, op_num);
+    for (auto &&queue : queues) {
+      for (auto &&ops : queue) {
+        WriteRecord(out, ops);
+      }
+    }
+    out.close();
+    return !out.fail();
+  }
+
+  /**
+   * @brief Write the header of a trace whose records have kTargetNum index slots.
+   *
+   * @param out an output stream in binary mode.
+   * @param field_num the number of target fields that indices refer to.
+   * @param op_num the number of operations to be written.
+   */
+  static void
+  WriteHeader(  //
+      std::ostream &out,
+      const size_t field_num,
+      const size_t op_num)
+  {
+    const TraceHeader header{kTraceMagic, kTraceVersion, kTargetNum, field_num, op_num};
+    out.write(reinterpret_cast<const char *>(&header), sizeof(TraceHeader));
+  }
+
+  /**
+   * @brief Write an operation as a trace record.
+   *
+   * @param out an output stream in binary mode.
+   * @param ops an operation with the indices of target fields.
+   */
+  static void
+  WriteRecord(  //
+      std::ostream &out,
+      const CompactOperation &ops)
+  {
+    std::array<Word_t, kTargetNum + 1> record{};
+    record[0] = ops.GetWidth() | (static_cast<Word_t>(ops.GetType()) << kTypeShift);
+    for (size_t j = 0; j < ops.GetWidth(); ++j) {
+      record[j + 1] = ops.GetIndex(j);
+    }
+    out.write(reinterpret_cast<const char *>(record.data()), sizeof(record));
+  }
+
+ private:
+  /*################################################################################################
+   * Internal constants
+   *##############################################################################################*/
+
+  /// a mask to extract a width from the head word of a record
+  static constexpr Word_t kWidthMask = 0xFFFF;
+
+  /// the position of an operation type in the head word of a record
+  static constexpr size_t kTypeShift = 16;
+
+  /*################################################################################################
+   * Internal utility functions
+   *##############################################################################################*/
+
+  /**
+   * @return an empty string if a mapped trace is valid, or the reason otherwise.
+   */
+  std::string
+  Verify()
+  {
+    std::memcpy(&header_, map_head_, sizeof(TraceHeader));
+    if (header_.magic != kTraceMagic || header_.version != kTraceVersion) {
+      return "not a trace file of version " + std::to_string(kTraceVersion);
+    }
+    if (header_.max_width == 0 || header_.field_num == 0
+        || header_.field_num > std::numeric_limits<Word_t>::max() + 1UL) {
+      return "an invalid header";
+    }
+
+    record_words_ = header_.max_width + 1UL;
+    const auto record_size = record_words_ * sizeof(Word_t);
+    if ((map_size_ - sizeof(TraceHeader)) / record_size != header_.op_num
+        || (map_size_ - sizeof(TraceHeader)) % record_size != 0) {
+      return "the file size does not match " + std::to_string(header_.op_num) + " records";
+    }
+    records_ = reinterpret_cast<const Word_t *>(static_cast<std::byte *>(map_head_)
+                                                + sizeof(TraceHeader));
+
+    size_t first_width = 0;
+    for (size_t i = 0; i < header_.op_num; ++i) {
+      CompactOperation ops{};
+      if (!Read(i, ops)) return "an invalid record at " + std::to_string(i);
+      if (first_width == 0) first_width = ops.GetWidth();
+      has_reads_ |= ops.GetType() == kRead;
+      has_variable_widths_ |= ops.GetWidth() != first_width;
+      const auto *indices = records_ + i * record_words_ + 1;
+      has_unsorted_records_ |= !std::is_sorted(indices, indices + ops.GetWidth());
+    }
+    return "";
+  }
+
+  /*################################################################################################
+   * Internal member variables
+   *##############################################################################################*/
+
+  /// the head address of a mapping
+  void *map_head_{MAP_FAILED};
+
+  /// the size of a mapping in bytes
+  size_t map_size_{0};
+
+  /// a copy of the header
+  TraceHeader header_{};
+
+  /// the head address of records
+  const Word_t *records_{nullptr};
+
+  /// the number of words in each record
+  size_t record_words_{0};
+
+  /// a flag to indicate a trace includes read operations
+  bool has_reads_{false};
+
+  /// a flag to indicate operations have various widths
+  bool has_variable_widths_{false};
+
+  /// a flag to indicate some records have targets in descending order
+  bool has_unsorted_records_{false};
+
+  /// the reason why a trace is invalid (empty if valid)
+  std::string error_{};
+};
+
+/**
+ * @brief A class to replay a trace in per-worker partitions.
+ *
+ * Each worker replays a contiguous partition of records directly from a mapping, where the
+ * i-th worker replays the i-th partition of a trace dumped with the same number of workers.
+ * This class provides the same batch interface as OperationEngine.
+ */
+class TraceReplayer
+{
+ public:
+  /*################################################################################################
+   * Public constructors and assignment operators
+   *##############################################################################################*/
+
+  /**
+   * @param trace a verified trace.
+   * @param target_fields target fields that the trace refers to.
+   * @param worker_num the number of workers.
+   * @param presort a flag to sort targets before measurement (otherwise targets are sorted
+   * in each MwCAS operation).
+   */
+  TraceReplayer(  //
+      const OperationTrace &trace,
+      const TargetFields &target_fields,
+      const size_t worker_num,
+      const bool presort = true)
+      : trace_{trace}, target_fields_{target_fields}, presort_{presort}
+  {
+    size_t begin = 0;
+    for (size_t i = 0; i < worker_num; ++i) {
+      begins_.emplace_back(begin);
+      begin += (trace_.GetOpNum() + i) / worker_num;
+    }
+  }
+
+  TraceReplayer(const TraceReplayer &) = delete;
+  TraceReplayer &operator=(const TraceReplayer &obj) = delete;
+  TraceReplayer(TraceReplayer &&) = delete;
+  TraceReplayer &operator=(TraceReplayer &&) = delete;
+
+  /*################################################################################################
+   * Public destructors
+   *##############################################################################################*/
+
+  ~TraceReplayer() = default;
+
+  /*################################################################################################
+   * Public utility functions
+   *##############################################################################################*/
+
+  /**
+   * @brief Read operations of a worker's partition into a given buffer.
+   *
+   * @tparam RandEngine the class of a random engine (unused).
+   * @tparam Op the class of operations in a buffer.
+   * @param n the number of operations to be read.
+   * @param worker_id the ID of a calling worker.
+   * @param op_offset the number of operations read by the worker so far.
+   * @param batch a buffer to store read operations.
+   */
+  template <class RandEngine, class Op>
+  void
+  GenerateBatch(  //
+      const size_t n,
+      [[maybe_unused]] RandEngine &rand_engine,
+      const size_t worker_id,
+      const size_t op_offset,
+      Op *batch) const
+  {
+    const auto begin = begins_[worker_id] + op_offset;
+    for (size_t i = 0; i < n; ++i) {
+      CompactOperation ops{};
+      trace_.ReadVerified(begin + i, presort_, ops);
+      if constexpr (std::is_same_v<Op, CompactOperation>) {
+        batch[i] = ops;
+      } else {
+        batch[i] = ops.Decode(target_fields_);
+      }
+    }
+  }
+
+ private:
+  /*################################################################################################
+   * Internal member variables
+   *##############################################################################################*/
+
+  /// a verified trace
+  const OperationTrace &trace_;
+
+  /// target fields that a trace refers to
+  const TargetFields &target_fields_;
+
+  /// a flag to sort targets of unsorted records
+  const bool presort_;
+
+  /// the first record of each worker's partition
+  std::vector<size_t> begins_{};
+};
+
+#endif  // MWCAS_BENCHMARK_OPERATION_TRACE_H
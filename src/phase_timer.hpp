@@ -0,0 +1,161 @@
+/*
+ * Copyright 2021 Database Group, Nagoya University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MWCAS_BENCHMARK_PHASE_TIMER_H
+#define MWCAS_BENCHMARK_PHASE_TIMER_H
+
+#include <x86intrin.h>
+
+#include <array>
+
+#include "common.hpp"
+
+/*##################################################################################################
+ * Global enums
+ *################################################################################################*/
+
+/**
+ * @brief Phases of an MwCAS operation.
+ *
+ */
+enum Phase : uint8_t
+{
+  /// sort targets in a measured path (only if operations are not sorted in advance)
+  kSortPhase,
+  /// read the old values of target words
+  kReadPhase,
+  /// spend think time between reads and MwCAS
+  kThinkPhase,
+  /// allocate (or initialize) a descriptor
+  kAllocatePhase,
+  /// protect/unprotect an epoch (PMwCAS only)
+  kEpochPhase,
+  /// add targets to a descriptor
+  kBuildPhase,
+  /// commit an MwCAS operation (or single-word CAS operations)
+  kCommitPhase,
+  /// back off after failed attempts
+  kBackoffPhase,
+};
+
+/// the number of phases
+constexpr size_t kPhaseNum = 8;
+
+/**
+ * @param phase a phase of an MwCAS operation.
+ * @return the name of the phase.
+ */
+constexpr const char *
+ToString(const Phase phase)
+{
+  switch (phase) {
+    case kSortPhase:
+      return "sort";
+    case kReadPhase:
+      return "read";
+    case kThinkPhase:
+      return "think";
+    case kAllocatePhase:
+      return "allocate";
+    case kEpochPhase:
+      return "epoch";
+    case kBuildPhase:
+      return "build";
+    case kCommitPhase:
+      return "commit";
+    case kBackoffPhase:
+    default:
+      return "backoff";
+  }
+}
+
+/**
+ * @brief A timer to attribute TSC cycles of a sampled operation to its phases.
+ *
+ * Each lap attributes the cycles since the previous lap to a given phase. Since rdtsc is not
+ * serialized, a breakdown is approximate and includes the overhead of timestamps themselves
+ * (tens of cycles per lap).
+ */
+class PhaseTimer
+{
+ public:
+  /*################################################################################################
+   * Public utility functions
+   *##############################################################################################*/
+
+  /**
+   * @brief Start measuring an operation.
+   *
+   */
+  void
+  Start()
+  {
+    last_tsc_ = __rdtsc();
+  }
+
+  /**
+   * @brief Attribute the cycles since the last lap to a given phase.
+   *
+   * @param phase the phase that has just finished.
+   */
+  void
+  Lap(const Phase phase)
+  {
+    const auto tsc = __rdtsc();
+    cycles_[phase] += tsc - last_tsc_;
+    last_tsc_ = tsc;
+  }
+
+  /**
+   * @return the cycles spent in each phase.
+   */
+  constexpr const std::array<size_t, kPhaseNum> &
+  GetCycles() const
+  {
+    return cycles_;
+  }
+
+ private:
+  /*################################################################################################
+   * Internal member variables
+   *##############################################################################################*/
+
+  /// the timestamp of the last lap
+  size_t last_tsc_{0};
+
+  /// the cycles spent in each phase
+  std::array<size_t, kPhaseNum> cycles_{};
+};
+
+/**
+ * @brief A timer that does nothing for operations that are not sampled.
+ *
+ */
+class NoPhaseTimer
+{
+ public:
+  constexpr void
+  Start()
+  {
+  }
+
+  constexpr void
+  Lap([[maybe_unused]] const Phase phase)
+  {
+  }
+};
+
+#endif  // MWCAS_BENCHMARK_PHASE_TIMER_H
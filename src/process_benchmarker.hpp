@@ -0,0 +1,323 @@
+/*
+ * Copyright 2021 Database Group, Nagoya University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MWCAS_BENCHMARK_PROCESS_BENCHMARKER_H
+#define MWCAS_BENCHMARK_PROCESS_BENCHMARKER_H
+
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <exception>
+#include <iostream>
+#include <new>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common.hpp"
+#include "memory_region.hpp"
+#include "mwcas_target.hpp"
+#include "numa_placement.hpp"
+#include "operation_engine.hpp"
+
+/**
+ * @brief A class to measure throughput with forked worker processes.
+ *
+ * Target fields must be placed in a shared memory region before this class forks workers,
+ * so that every worker accesses the same fields at the same virtual addresses. Each worker
+ * generates its own operations after forking.
+ *
+ * @tparam Target a benchmark target.
+ */
+template <class Target>
+class ProcessBenchmarker
+{
+  /*################################################################################################
+   * Type aliases
+   *##############################################################################################*/
+
+  using Clock_t = ::std::chrono::high_resolution_clock;
+
+ public:
+  /*################################################################################################
+   * Public constructors and assignment operators
+   *##############################################################################################*/
+
+  ProcessBenchmarker(  //
+      Target &bench_target,
+      OperationEngine &ops_engine,
+      const NUMAPlacement &placement,
+      const size_t exec_num,
+      const size_t process_num,
+      const size_t random_seed,
+      const bool output_as_csv,
+      const std::string &target_name)
+      : bench_target_{bench_target},
+        ops_engine_{ops_engine},
+        placement_{placement},
+        exec_num_{exec_num},
+        process_num_{process_num},
+        random_seed_{random_seed},
+        output_as_csv_{output_as_csv},
+        target_name_{target_name},
+        shm_{sizeof(Header) + process_num * sizeof(ProcessSlot), kNoHugePage, true},
+        header_{new (shm_.Get()) Header{}},
+        slots_{new (header_ + 1) ProcessSlot[process_num]}
+  {
+  }
+
+  ProcessBenchmarker(const ProcessBenchmarker &) = delete;
+  ProcessBenchmarker &operator=(const ProcessBenchmarker &obj) = delete;
+  ProcessBenchmarker(ProcessBenchmarker &&) = delete;
+  ProcessBenchmarker &operator=(ProcessBenchmarker &&) = delete;
+
+  /*################################################################################################
+   * Public destructors
+   *##############################################################################################*/
+
+  ~ProcessBenchmarker() = default;
+
+  /*################################################################################################
+   * Public utility functions
+   *##############################################################################################*/
+
+  /**
+   * @brief Fork workers, run them simultaneously, and output throughput.
+   *
+   * If a worker process fails (e.g., it cannot prepare its operations), the other workers are
+   * killed and std::runtime_error is thrown with the status of the failed one.
+   */
+  void
+  Run()
+  {
+    if (!output_as_csv_) std::cout << "*** START " << target_name_ << " ***" << std::endl;
+
+    std::mt19937_64 rand_engine{random_seed_};
+    std::vector<pid_t> pids{};
+    for (size_t i = 0; i < process_num_; ++i) {
+      const size_t n = (exec_num_ + i) / process_num_;
+      const auto seed = rand_engine();
+      const auto pid = fork();
+      if (pid == 0) {
+        try {
+          RunWorker(i, n, seed);
+        } catch (const std::exception &e) {
+          std::cerr << e.what() << std::endl;
+          _exit(1);
+        }
+        _exit(0);
+      }
+      if (pid < 0) {
+        std::cerr << "Failed to fork worker processes." << std::endl;
+        break;
+      }
+      pids.emplace_back(pid);
+    }
+
+    // start measurement after all the workers have generated their operations
+    while (header_->ready_num.load(std::memory_order_acquire) < pids.size()) {
+      for (size_t i = 0; i < pids.size(); ++i) {
+        int status = 0;
+        if (waitpid(pids[i], &status, WNOHANG) != pids[i]) continue;
+
+        // a worker has exited without getting ready, so the others would wait forever
+        pids.erase(pids.begin() + i);
+        for (auto &&pid : pids) {
+          kill(pid, SIGKILL);
+          waitpid(pid, nullptr, 0);
+        }
+        throw std::runtime_error{"a worker process exited before measurement ("
+                                 + DescribeStatus(status) + ")"};
+      }
+      std::this_thread::yield();
+    }
+    header_->start.store(true, std::memory_order_release);
+    std::string failure{};
+    for (auto &&pid : pids) {
+      int status = 0;
+      waitpid(pid, &status, 0);
+      if (failure.empty() && !(WIFEXITED(status) && WEXITSTATUS(status) == 0)) {
+        failure = DescribeStatus(status);
+      }
+    }
+    if (!failure.empty()) {
+      throw std::runtime_error{"a worker process failed in measurement (" + failure + ")"};
+    }
+    if (pids.size() < process_num_) return;
+
+    size_t total_exec_num = 0;
+    size_t max_elapsed = 0;
+    for (size_t i = 0; i < process_num_; ++i) {
+      total_exec_num += slots_[i].exec_num;
+      max_elapsed = std::max(max_elapsed, slots_[i].elapsed_nano);
+      gen_nano_ = std::max(gen_nano_, slots_[i].gen_nano);
+    }
+    const auto throughput = total_exec_num / (max_elapsed / 1E9);
+
+    if (output_as_csv_) {
+      std::cout << throughput << std::endl;
+    } else {
+      std::cout << "Throughput [Ops/s]: " << throughput << std::endl;
+    }
+  }
+
+  /**
+   * @return the longest time to generate operations in a worker in seconds.
+   */
+  double
+  GetGenerationTime() const
+  {
+    return gen_nano_ / 1E9;
+  }
+
+ private:
+  /*################################################################################################
+   * Internal classes
+   *##############################################################################################*/
+
+  /**
+   * @brief A class to synchronize worker processes.
+   *
+   */
+  struct alignas(kCacheLineSize) Header {
+    /// the number of workers that are ready for measurement
+    std::atomic_size_t ready_num{0};
+
+    /// a flag to start measurement
+    std::atomic_bool start{false};
+  };
+
+  /**
+   * @brief A class to hold the results and a descriptor of each worker process.
+   *
+   */
+  struct alignas(kCacheLineSize) ProcessSlot {
+    /// the number of executed operations
+    size_t exec_num{0};
+
+    /// elapsed time for measurement in nanoseconds
+    size_t elapsed_nano{0};
+
+    /// elapsed time for generating operations in nanoseconds
+    size_t gen_nano{0};
+
+    /// a shared descriptor of our MwCAS
+    alignas(MwCAS) std::byte desc[sizeof(MwCAS)];
+  };
+
+  /*################################################################################################
+   * Internal utility functions
+   *##############################################################################################*/
+
+  /**
+   * @brief Run a worker in a forked process.
+   *
+   * @param worker_id the ID of a worker.
+   * @param n the number of operations to be executed.
+   * @param random_seed a random seed for generating operations.
+   */
+  void
+  RunWorker(  //
+      const size_t worker_id,
+      const size_t n,
+      const size_t random_seed)
+  {
+    auto &slot = slots_[worker_id];
+    if (placement_.PinWorkers()) placement_.PinThread(worker_id);
+    shared_mwcas_desc = reinterpret_cast<MwCAS *>(slot.desc);
+
+    auto start_time = Clock_t::now();
+    const auto operations = ops_engine_.Generate(n, random_seed, worker_id);
+    slot.gen_nano = GetElapsedNano(start_time);
+
+    header_->ready_num.fetch_add(1, std::memory_order_release);
+    while (!header_->start.load(std::memory_order_acquire)) {
+      // wait for the other workers
+    }
+
+    start_time = Clock_t::now();
+    bench_target_.ExecuteBatch(operations.data(), operations.size());
+    slot.elapsed_nano = GetElapsedNano(start_time);
+    slot.exec_num = n;
+  }
+
+  /**
+   * @param status the status of a terminated worker process.
+   * @return a description of the status.
+   */
+  static std::string
+  DescribeStatus(const int status)
+  {
+    if (WIFSIGNALED(status)) return "killed by signal " + std::to_string(WTERMSIG(status));
+    return "exit status " + std::to_string(WEXITSTATUS(status));
+  }
+
+  static size_t
+  GetElapsedNano(const Clock_t::time_point &start_time)
+  {
+    const auto elapsed = Clock_t::now() - start_time;
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+  }
+
+  /*################################################################################################
+   * Internal member variables
+   *##############################################################################################*/
+
+  /// a benchmark target
+  Target &bench_target_;
+
+  /// an engine to generate operations
+  OperationEngine &ops_engine_;
+
+  /// placement of worker processes
+  const NUMAPlacement &placement_;
+
+  /// the total number of operations
+  const size_t exec_num_;
+
+  /// the number of worker processes
+  const size_t process_num_;
+
+  /// a base random seed
+  const size_t random_seed_;
+
+  /// a flag to output results as CSV format
+  const bool output_as_csv_;
+
+  /// the name of a benchmark target
+  const std::string target_name_;
+
+  /// a shared memory region for synchronization and results
+  MemoryRegion shm_;
+
+  /// a header in the shared memory region
+  Header *header_;
+
+  /// slots of worker processes in the shared memory region
+  ProcessSlot *slots_;
+
+  /// the longest time to generate operations in nanoseconds
+  size_t gen_nano_{0};
+};
+
+#endif  // MWCAS_BENCHMARK_PROCESS_BENCHMARKER_H
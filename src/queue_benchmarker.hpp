@@ -0,0 +1,104 @@
+/*
+ * Copyright 2021 Database Group, Nagoya University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MWCAS_BENCHMARK_QUEUE_BENCHMARKER_H
+#define MWCAS_BENCHMARK_QUEUE_BENCHMARKER_H
+
+#include <string>
+
+#include "common.hpp"
+#include "numa_placement.hpp"
+#include "operation_engine.hpp"
+#include "thread_driver.hpp"
+
+/**
+ * @brief A class to measure throughput by replaying whole operation queues in batches.
+ *
+ * Each worker thread prepares its operation queue as the default benchmarker does, and then
+ * passes the entire queue to the target at once. Thus, the target can prefetch the queue
+ * entries and target words of later operations in the main replay loop (see
+ * MwCASTarget::ExecuteBatch), which is impossible when operations are executed one by one.
+ *
+ * @tparam Target a benchmark target.
+ */
+template <class Target>
+class QueueBenchmarker
+{
+ public:
+  /*################################################################################################
+   * Public constructors and assignment operators
+   *##############################################################################################*/
+
+  QueueBenchmarker(  //
+      Target &bench_target,
+      OperationEngine &ops_engine,
+      const NUMAPlacement &placement,
+      const size_t exec_num,
+      const size_t thread_num,
+      const size_t random_seed,
+      const bool output_as_csv,
+      const std::string &target_name)
+      : bench_target_{bench_target},
+        ops_engine_{ops_engine},
+        driver_{placement, exec_num, thread_num, random_seed, output_as_csv, target_name}
+  {
+  }
+
+  QueueBenchmarker(const QueueBenchmarker &) = delete;
+  QueueBenchmarker &operator=(const QueueBenchmarker &obj) = delete;
+  QueueBenchmarker(QueueBenchmarker &&) = delete;
+  QueueBenchmarker &operator=(QueueBenchmarker &&) = delete;
+
+  /*################################################################################################
+   * Public destructors
+   *##############################################################################################*/
+
+  ~QueueBenchmarker() = default;
+
+  /*################################################################################################
+   * Public utility functions
+   *##############################################################################################*/
+
+  /**
+   * @brief Prepare operation queues, run workers simultaneously, and output throughput.
+   *
+   */
+  void
+  Run()
+  {
+    driver_.Run([&](const size_t worker_id, const size_t n, const size_t random_seed) {
+      return [&, operations = ops_engine_.Generate(n, random_seed, worker_id)] {
+        bench_target_.ExecuteBatch(operations.data(), operations.size());
+      };
+    });
+  }
+
+ private:
+  /*################################################################################################
+   * Internal member variables
+   *##############################################################################################*/
+
+  /// a benchmark target
+  Target &bench_target_;
+
+  /// an engine to prepare operation queues
+  OperationEngine &ops_engine_;
+
+  /// a driver of worker threads
+  const ThreadDriver driver_;
+};
+
+#endif  // MWCAS_BENCHMARK_QUEUE_BENCHMARKER_H
@@ -0,0 +1,123 @@
+/*
+ * Copyright 2021 Database Group, Nagoya University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MWCAS_BENCHMARK_RECORD_LAYOUT_H
+#define MWCAS_BENCHMARK_RECORD_LAYOUT_H
+
+#include "common.hpp"
+
+/**
+ * @brief A layout of isolated target words without any payload.
+ *
+ */
+class WordLayout
+{
+ public:
+  /*################################################################################################
+   * Public constructors and assignment operators
+   *##############################################################################################*/
+
+  WordLayout(  //
+      [[maybe_unused]] const size_t payload_touch_bytes,
+      [[maybe_unused]] const bool write_payload)
+  {
+  }
+
+  /*################################################################################################
+   * Public utility functions
+   *##############################################################################################*/
+
+  /**
+   * @brief Do nothing because there is no payload around target words.
+   *
+   */
+  constexpr void
+  TouchPayload([[maybe_unused]] uint64_t *word) const
+  {
+  }
+};
+
+/**
+ * @brief A layout of target words embedded in records (e.g., headers of index nodes).
+ *
+ * Each operation touches the payload that follows each target word in its record, so that
+ * results include cold payload traffic around MwCAS words.
+ */
+class RecordLayout
+{
+ public:
+  /*################################################################################################
+   * Public constructors and assignment operators
+   *##############################################################################################*/
+
+  /**
+   * @brief Construct a new RecordLayout object.
+   *
+   * @param payload_touch_bytes the number of payload bytes touched per target word.
+   * @param write_payload a flag to write (true) or read (false) payloads.
+   */
+  RecordLayout(  //
+      const size_t payload_touch_bytes,
+      const bool write_payload)
+      : payload_word_num_{payload_touch_bytes / sizeof(uint64_t)}, write_payload_{write_payload}
+  {
+  }
+
+  /*################################################################################################
+   * Public utility functions
+   *##############################################################################################*/
+
+  /**
+   * @brief Read or write the payload next to a given target word.
+   *
+   * Payloads are accessed with relaxed atomics because they are shared by workers without
+   * any synchronization.
+   *
+   * @param word the address of a target word.
+   */
+  void
+  TouchPayload(uint64_t *word) const
+  {
+    auto *payload = word + 1;
+    if (write_payload_) {
+      for (size_t i = 0; i < payload_word_num_; ++i) {
+        __atomic_store_n(payload + i, i, __ATOMIC_RELAXED);
+      }
+    } else {
+      uint64_t sum = 0;
+      for (size_t i = 0; i < payload_word_num_; ++i) {
+        sum += __atomic_load_n(payload + i, __ATOMIC_RELAXED);
+      }
+      sink_ = sum;
+    }
+  }
+
+ private:
+  /*################################################################################################
+   * Internal member variables
+   *##############################################################################################*/
+
+  /// the number of payload words touched per target word
+  size_t payload_word_num_;
+
+  /// a flag to write (true) or read (false) payloads
+  bool write_payload_;
+
+  /// a sink to prevent payload reads from being optimized away
+  static inline thread_local volatile uint64_t sink_{0};
+};
+
+#endif  // MWCAS_BENCHMARK_RECORD_LAYOUT_H
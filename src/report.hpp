@@ -0,0 +1,137 @@
+/*
+ * Copyright 2021 Database Group, Nagoya University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MWCAS_BENCHMARK_REPORT_H
+#define MWCAS_BENCHMARK_REPORT_H
+
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief A class to collect supplementary results in addition to throughput/latency.
+ *
+ * Rows are buffered until the benchmark finishes so that they do not interleave with the
+ * output of a benchmarker. In CSV format, each row is output as a comment line (i.e.,
+ * "#<section>,<key>,<value>") to keep the main result line intact.
+ */
+class Report
+{
+ public:
+  /*################################################################################################
+   * Public constructors and assignment operators
+   *##############################################################################################*/
+
+  explicit Report(const bool output_as_csv) : output_as_csv_{output_as_csv} {}
+
+  Report(const Report &) = delete;
+  Report &operator=(const Report &obj) = delete;
+  Report(Report &&) = default;
+  Report &operator=(Report &&) = default;
+
+  /*################################################################################################
+   * Public destructors
+   *##############################################################################################*/
+
+  ~Report() = default;
+
+  /*################################################################################################
+   * Public utility functions
+   *##############################################################################################*/
+
+  /**
+   * @brief Add a result row.
+   *
+   * @tparam T the type of a value.
+   * @param section a group name of a row.
+   * @param key the name of a value.
+   * @param value a value to be output.
+   */
+  template <class T>
+  void
+  Add(  //
+      const std::string &section,
+      const std::string &key,
+      const T &value)
+  {
+    std::ostringstream out;
+    out << value;
+    rows_.emplace_back(Row{section, key, out.str()});
+  }
+
+  /**
+   * @brief Output all the buffered rows to stdout.
+   *
+   * Rows are grouped by sections in the order of their first appearance.
+   */
+  void
+  Output() const
+  {
+    std::vector<std::string> sections{};
+    for (auto &&row : rows_) {
+      if (std::find(sections.begin(), sections.end(), row.section) == sections.end()) {
+        sections.emplace_back(row.section);
+      }
+    }
+
+    for (auto &&target_section : sections) {
+      if (!output_as_csv_) std::cout << "--- " << target_section << " ---" << std::endl;
+      for (auto &&[section, key, value] : rows_) {
+        if (section != target_section) continue;
+
+        if (output_as_csv_) {
+          std::cout << "#" << section << "," << key << "," << value << std::endl;
+        } else {
+          std::cout << "  " << key << ": " << value << std::endl;
+        }
+      }
+    }
+  }
+
+ private:
+  /*################################################################################################
+   * Internal classes
+   *##############################################################################################*/
+
+  /**
+   * @brief A class to represent a result row.
+   *
+   */
+  struct Row {
+    /// a group name of a row
+    std::string section;
+
+    /// the name of a value
+    std::string key;
+
+    /// a formatted value
+    std::string value;
+  };
+
+  /*################################################################################################
+   * Internal member variables
+   *##############################################################################################*/
+
+  /// a flag to output rows as CSV format
+  bool output_as_csv_;
+
+  /// buffered result rows
+  std::vector<Row> rows_;
+};
+
+#endif  // MWCAS_BENCHMARK_REPORT_H
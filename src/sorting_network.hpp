@@ -0,0 +1,134 @@
+/*
+ * Copyright 2021 Database Group, Nagoya University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MWCAS_BENCHMARK_SORTING_NETWORK_H
+#define MWCAS_BENCHMARK_SORTING_NETWORK_H
+
+#include <algorithm>
+#include <array>
+#include <utility>
+
+#include "common.hpp"
+
+/**
+ * @brief A sorting network (Batcher's odd-even merge sort) for a fixed number of elements.
+ *
+ * Comparators are computed at compile time, and each of them is a branch-free compare-exchange.
+ * Thus, sorting does not depend on data, unlike std::sort whose branches mispredict on random
+ * targets. This is useful for sorting the targets of wide MwCAS operations.
+ *
+ * @tparam N the number of elements.
+ */
+template <size_t N>
+class SortingNetwork
+{
+ public:
+  /*################################################################################################
+   * Public utility functions
+   *##############################################################################################*/
+
+  /**
+   * @brief Sort elements in ascending order.
+   *
+   * @tparam T the class of elements.
+   * @param elements elements to be sorted.
+   */
+  template <class T>
+  static void
+  Sort(std::array<T, N> &elements)
+  {
+    for (auto &&[i, j] : kComparators) {
+      const auto lo = std::min(elements[i], elements[j]);
+      const auto hi = std::max(elements[i], elements[j]);
+      elements[i] = lo;
+      elements[j] = hi;
+    }
+  }
+
+  /**
+   * @return the number of comparators in this network.
+   */
+  static constexpr size_t
+  size()
+  {
+    return kComparatorNum;
+  }
+
+ private:
+  /*################################################################################################
+   * Internal utility functions
+   *##############################################################################################*/
+
+  /**
+   * @brief Enumerate the comparators of Batcher's odd-even merge sort for any N.
+   *
+   * @tparam Func the class of a function to receive each comparator.
+   * @param func a function to receive each comparator.
+   */
+  template <class Func>
+  static constexpr void
+  ForEachComparator(Func &&func)
+  {
+    for (size_t p = 1; p < N; p += p) {
+      for (size_t k = p; k > 0; k /= 2) {
+        for (size_t j = k % p; j + k < N; j += k + k) {
+          for (size_t i = 0; i < k && i + j + k < N; ++i) {
+            if ((i + j) / (p + p) == (i + j + k) / (p + p)) func(i + j, i + j + k);
+          }
+        }
+      }
+    }
+  }
+
+  /**
+   * @return the number of comparators.
+   */
+  static constexpr size_t
+  CountComparators()
+  {
+    size_t count = 0;
+    ForEachComparator([&count](size_t, size_t) { ++count; });
+    return count;
+  }
+
+  /**
+   * @return the pairs of positions to be compared in order.
+   */
+  static constexpr auto
+  MakeComparators()
+  {
+    std::array<std::pair<size_t, size_t>, CountComparators()> comparators{};
+    size_t count = 0;
+    ForEachComparator([&](const size_t i, const size_t j) {
+      comparators[count].first = i;
+      comparators[count].second = j;
+      ++count;
+    });
+    return comparators;
+  }
+
+  /*################################################################################################
+   * Internal constants
+   *##############################################################################################*/
+
+  /// the number of comparators
+  static constexpr size_t kComparatorNum = CountComparators();
+
+  /// the pairs of positions to be compared in order
+  static constexpr auto kComparators = MakeComparators();
+};
+
+#endif  // MWCAS_BENCHMARK_SORTING_NETWORK_H
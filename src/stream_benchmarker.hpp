@@ -0,0 +1,143 @@
+/*
+ * Copyright 2021 Database Group, Nagoya University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MWCAS_BENCHMARK_STREAM_BENCHMARKER_H
+#define MWCAS_BENCHMARK_STREAM_BENCHMARKER_H
+
+#include <algorithm>
+#include <array>
+#include <string>
+
+#include "common.hpp"
+#include "numa_placement.hpp"
+#include "operation.hpp"
+#include "operation_engine.hpp"
+#include "thread_driver.hpp"
+#include "xoshiro.hpp"
+
+/*##################################################################################################
+ * Global constants
+ *################################################################################################*/
+
+/// the number of operations generated at once by each worker (fits in L1 caches)
+constexpr size_t kStreamBatchSize = 64;
+
+/**
+ * @brief A class to measure throughput with operations generated on the fly.
+ *
+ * Each worker thread generates operations in small batches with its own fast random engine
+ * and executes them immediately, so that measurement does not include the memory traffic of
+ * replaying materialized operation queues. Instead, it includes the cost of generation.
+ * Operations may be also read from a mapped trace in the same manner (see TraceReplayer).
+ * Each batch is executed by the target at once, which may prefetch the targets of later
+ * operations in the batch (see MwCASTarget::ExecuteBatch).
+ *
+ * @tparam Target a benchmark target.
+ * @tparam OperationSource a class to provide batches of operations.
+ */
+template <class Target, class OperationSource = OperationEngine>
+class StreamBenchmarker
+{
+ public:
+  /*################################################################################################
+   * Public constructors and assignment operators
+   *##############################################################################################*/
+
+  StreamBenchmarker(  //
+      Target &bench_target,
+      OperationSource &ops_source,
+      const NUMAPlacement &placement,
+      const size_t exec_num,
+      const size_t thread_num,
+      const size_t random_seed,
+      const bool output_as_csv,
+      const std::string &target_name)
+      : bench_target_{bench_target},
+        ops_source_{ops_source},
+        driver_{placement, exec_num, thread_num, random_seed, output_as_csv, target_name}
+  {
+  }
+
+  StreamBenchmarker(const StreamBenchmarker &) = delete;
+  StreamBenchmarker &operator=(const StreamBenchmarker &obj) = delete;
+  StreamBenchmarker(StreamBenchmarker &&) = delete;
+  StreamBenchmarker &operator=(StreamBenchmarker &&) = delete;
+
+  /*################################################################################################
+   * Public destructors
+   *##############################################################################################*/
+
+  ~StreamBenchmarker() = default;
+
+  /*################################################################################################
+   * Public utility functions
+   *##############################################################################################*/
+
+  /**
+   * @brief Run workers simultaneously and output throughput.
+   *
+   */
+  void
+  Run()
+  {
+    driver_.Run([&](const size_t worker_id, const size_t n, const size_t random_seed) {
+      return [&, worker_id, n, random_seed] { RunWorker(worker_id, n, random_seed); };
+    });
+  }
+
+ private:
+  /*################################################################################################
+   * Internal utility functions
+   *##############################################################################################*/
+
+  /**
+   * @brief Generate and execute operations batch by batch.
+   *
+   * @param worker_id the ID of a worker.
+   * @param n the number of operations to be executed.
+   * @param random_seed a random seed for generating operations.
+   */
+  void
+  RunWorker(  //
+      const size_t worker_id,
+      const size_t n,
+      const size_t random_seed)
+  {
+    Xoshiro256 rand_engine{random_seed};
+    std::array<QueuedOperation, kStreamBatchSize> batch{};
+
+    for (size_t done = 0; done < n; done += kStreamBatchSize) {
+      const auto batch_size = std::min(kStreamBatchSize, n - done);
+      ops_source_.GenerateBatch(batch_size, rand_engine, worker_id, done, batch.data());
+      bench_target_.ExecuteBatch(batch.data(), batch_size);
+    }
+  }
+
+  /*################################################################################################
+   * Internal member variables
+   *##############################################################################################*/
+
+  /// a benchmark target
+  Target &bench_target_;
+
+  /// a source of operations (e.g., an engine to generate them)
+  OperationSource &ops_source_;
+
+  /// a driver of worker threads
+  const ThreadDriver driver_;
+};
+
+#endif  // MWCAS_BENCHMARK_STREAM_BENCHMARKER_H
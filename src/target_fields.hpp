@@ -0,0 +1,215 @@
+/*
+ * Copyright 2021 Database Group, Nagoya University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MWCAS_BENCHMARK_TARGET_FIELDS_H
+#define MWCAS_BENCHMARK_TARGET_FIELDS_H
+
+#include <unistd.h>
+
+#include "common.hpp"
+#include "memory_region.hpp"
+
+/*##################################################################################################
+ * Global constants
+ *################################################################################################*/
+
+/// the size of a cache line in bytes
+constexpr size_t kCacheLineSize = 64;
+
+/// a stride for packing target words densely
+constexpr size_t kDenseStride = sizeof(uint64_t);
+
+/// a stride for placing each target word on its own cache line
+constexpr size_t kCacheLineStride = kCacheLineSize;
+
+/// a stride for placing each target word on its own adjacent-line pair
+constexpr size_t kLinePairStride = 2 * kCacheLineSize;
+
+/**
+ * @brief A class to manage MwCAS target words in one contiguous memory region.
+ *
+ * All the target words are placed in a single anonymous mapping with a given stride, so
+ * that false sharing between neighboring words can be controlled explicitly instead of
+ * depending on the placement of a memory allocator. The mapping may be backed by huge pages
+ * to keep dTLB misses out of measurement. Each stride may also be regarded as a record that
+ * embeds a target word at a given offset.
+ */
+class TargetFields
+{
+ public:
+  /*################################################################################################
+   * Public constructors and assignment operators
+   *##############################################################################################*/
+
+  /**
+   * @brief Construct a new TargetFields object.
+   *
+   * @param field_num the total number of target words.
+   * @param stride the distance between adjacent target words (i.e., a record size) in bytes.
+   * @param word_offset the offset of a target word in each record in bytes.
+   * @param huge_page_mode a backing mode of the memory region.
+   * @param shared a flag to share the memory region with forked processes.
+   */
+  TargetFields(  //
+      const size_t field_num,
+      const size_t stride,
+      const size_t word_offset,
+      const HugePageMode huge_page_mode,
+      const bool shared = false)
+      : field_num_{field_num},
+        stride_{stride},
+        region_{field_num * stride, huge_page_mode, shared},
+        head_{reinterpret_cast<std::byte *>(region_.Get()) + word_offset}
+  {
+  }
+
+  TargetFields(const TargetFields &) = delete;
+  TargetFields &operator=(const TargetFields &obj) = delete;
+  TargetFields(TargetFields &&) = delete;
+  TargetFields &operator=(TargetFields &&) = delete;
+
+  /*################################################################################################
+   * Public destructors
+   *##############################################################################################*/
+
+  ~TargetFields() = default;
+
+  /*################################################################################################
+   * Public getters
+   *##############################################################################################*/
+
+  /**
+   * @param i the index of a target word.
+   * @return the address of the i-th target word.
+   */
+  uint64_t *
+  operator[](const size_t i) const
+  {
+    return reinterpret_cast<uint64_t *>(head_ + i * stride_);
+  }
+
+  /**
+   * @return the total number of target words.
+   */
+  size_t
+  size() const
+  {
+    return field_num_;
+  }
+
+  /**
+   * @return the distance between adjacent target words in bytes.
+   */
+  size_t
+  GetStride() const
+  {
+    return stride_;
+  }
+
+  /**
+   * @return the head address of the memory region.
+   */
+  void *
+  GetRegion() const
+  {
+    return region_.Get();
+  }
+
+  /**
+   * @return the size of the memory region in bytes.
+   */
+  size_t
+  GetRegionSize() const
+  {
+    return region_.size();
+  }
+
+  /**
+   * @return the actual backing mode of the memory region.
+   */
+  HugePageMode
+  GetHugePageMode() const
+  {
+    return region_.GetMode();
+  }
+
+  /*################################################################################################
+   * Public utility functions
+   *##############################################################################################*/
+
+  /**
+   * @brief Initialize target words in a given range with zeros.
+   *
+   * Since the memory region is reserved lazily, this function also decides which thread
+   * touches the underlying pages first.
+   *
+   * @param begin the index of the first target word.
+   * @param end the index next to the last target word.
+   * @param store_addresses a flag to store the address of each word instead of zero (i.e.,
+   * target words are initialized as distinct pointers).
+   */
+  void
+  Initialize(  //
+      const size_t begin,
+      const size_t end,
+      const bool store_addresses = false) const
+  {
+    for (size_t i = begin; i < end; ++i) {
+      auto *word = (*this)[i];
+      *word = (store_addresses) ? reinterpret_cast<uint64_t>(word) : 0;
+    }
+  }
+
+  /**
+   * @brief Release the pages that are fully covered by a given range of target words.
+   *
+   * @param begin the index of the first target word.
+   * @param end the index next to the last target word.
+   */
+  void
+  Release(  //
+      const size_t begin,
+      const size_t end) const
+  {
+    const auto page_size = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+    const auto region_head = reinterpret_cast<uintptr_t>(region_.Get());
+    const auto head = (region_head + begin * stride_ + page_size - 1) & ~(page_size - 1);
+    const auto tail = (end == field_num_) ? region_head + region_.size()
+                                          : (region_head + end * stride_) & ~(page_size - 1);
+    if (head >= tail) return;
+
+    madvise(reinterpret_cast<void *>(head), tail - head, MADV_DONTNEED);
+  }
+
+ private:
+  /*################################################################################################
+   * Internal member variables
+   *##############################################################################################*/
+
+  /// the total number of target words
+  const size_t field_num_;
+
+  /// the distance between adjacent target words in bytes
+  const size_t stride_;
+
+  /// the memory region of target words
+  MemoryRegion region_;
+
+  /// the address of the first target word
+  std::byte *head_;
+};
+
+#endif  // MWCAS_BENCHMARK_TARGET_FIELDS_H
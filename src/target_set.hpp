@@ -0,0 +1,136 @@
+/*
+ * Copyright 2021 Database Group, Nagoya University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MWCAS_BENCHMARK_TARGET_SET_H
+#define MWCAS_BENCHMARK_TARGET_SET_H
+
+#include <array>
+
+#include "common.hpp"
+
+/**
+ * @brief A set of selected target fields to reject duplicates in an operation.
+ *
+ * Narrow operations are checked by a linear scan as before. Wide operations use open
+ * addressing instead so that selecting targets does not take quadratic time.
+ *
+ * @tparam N the maximum number of elements.
+ */
+template <size_t N = kTargetNum>
+class TargetSet
+{
+ public:
+  /*################################################################################################
+   * Public constructors and assignment operators
+   *##############################################################################################*/
+
+  TargetSet()
+  {
+    if constexpr (kUseHash) {
+      buckets_.fill(kEmpty);
+    }
+  }
+
+  TargetSet(const TargetSet &) = delete;
+  TargetSet &operator=(const TargetSet &obj) = delete;
+  TargetSet(TargetSet &&) = delete;
+  TargetSet &operator=(TargetSet &&) = delete;
+
+  /*################################################################################################
+   * Public destructors
+   *##############################################################################################*/
+
+  ~TargetSet() = default;
+
+  /*################################################################################################
+   * Public utility functions
+   *##############################################################################################*/
+
+  /**
+   * @param slot the index of a target field.
+   * @retval true if the field has been inserted.
+   * @retval false if the field has been already selected.
+   */
+  bool
+  Insert(const size_t slot)
+  {
+    if constexpr (kUseHash) {
+      for (auto pos = Hash(slot);; pos = (pos + 1) & (kBucketNum - 1)) {
+        if (buckets_[pos] == slot) return false;
+        if (buckets_[pos] == kEmpty) {
+          buckets_[pos] = slot;
+          return true;
+        }
+      }
+    } else {
+      for (size_t i = 0; i < size_; ++i) {
+        if (buckets_[i] == slot) return false;
+      }
+      buckets_[size_++] = slot;
+      return true;
+    }
+  }
+
+ private:
+  /*################################################################################################
+   * Internal constants
+   *##############################################################################################*/
+
+  /// the maximum number of elements checked by a linear scan
+  static constexpr size_t kLinearScanMax = 8;
+
+  /// a flag for using open addressing
+  static constexpr bool kUseHash = N > kLinearScanMax;
+
+  /// a sentinel for empty buckets
+  static constexpr size_t kEmpty = ~size_t{0};
+
+  /// the number of bits to address buckets (a load factor is at most 1/4)
+  static constexpr size_t kBucketBits = [] {
+    size_t bits = 0;
+    while ((size_t{1} << bits) < 4 * N) ++bits;
+    return bits;
+  }();
+
+  /// the number of buckets
+  static constexpr size_t kBucketNum = kUseHash ? (size_t{1} << kBucketBits) : N;
+
+  /*################################################################################################
+   * Internal utility functions
+   *##############################################################################################*/
+
+  /**
+   * @param slot the index of a target field.
+   * @return the home bucket of the field (Fibonacci hashing).
+   */
+  static constexpr size_t
+  Hash(const size_t slot)
+  {
+    return (slot * 0x9E3779B97F4A7C15UL) >> (64 - kBucketBits);
+  }
+
+  /*################################################################################################
+   * Internal member variables
+   *##############################################################################################*/
+
+  /// selected fields (a linear array or buckets of open addressing)
+  std::array<size_t, kBucketNum> buckets_;
+
+  /// the number of selected fields in a linear array
+  size_t size_{0};
+};
+
+#endif  // MWCAS_BENCHMARK_TARGET_SET_H
@@ -0,0 +1,156 @@
+/*
+ * Copyright 2021 Database Group, Nagoya University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MWCAS_BENCHMARK_THREAD_DRIVER_H
+#define MWCAS_BENCHMARK_THREAD_DRIVER_H
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common.hpp"
+#include "numa_placement.hpp"
+
+/**
+ * @brief A class to run worker threads simultaneously and output their throughput.
+ *
+ * This class is shared by the thread-based benchmarkers, which only differ in what each worker
+ * prepares before measurement and executes during it.
+ */
+class ThreadDriver
+{
+  /*################################################################################################
+   * Type aliases
+   *##############################################################################################*/
+
+  using Clock_t = ::std::chrono::high_resolution_clock;
+
+ public:
+  /*################################################################################################
+   * Public constructors and assignment operators
+   *##############################################################################################*/
+
+  ThreadDriver(  //
+      const NUMAPlacement &placement,
+      const size_t exec_num,
+      const size_t thread_num,
+      const size_t random_seed,
+      const bool output_as_csv,
+      const std::string &target_name)
+      : placement_{placement},
+        exec_num_{exec_num},
+        thread_num_{thread_num},
+        random_seed_{random_seed},
+        output_as_csv_{output_as_csv},
+        target_name_{target_name}
+  {
+  }
+
+  ThreadDriver(const ThreadDriver &) = delete;
+  ThreadDriver &operator=(const ThreadDriver &obj) = delete;
+  ThreadDriver(ThreadDriver &&) = delete;
+  ThreadDriver &operator=(ThreadDriver &&) = delete;
+
+  /*################################################################################################
+   * Public destructors
+   *##############################################################################################*/
+
+  ~ThreadDriver() = default;
+
+  /*################################################################################################
+   * Public utility functions
+   *##############################################################################################*/
+
+  /**
+   * @brief Run workers simultaneously and output throughput.
+   *
+   * Each worker is pinned if needed and calls `prepare(worker_id, n, random_seed)` before
+   * measurement, where `n` is the number of operations assigned to the worker. Measurement
+   * starts after all the workers have prepared, and then each worker calls the function that
+   * `prepare` has returned.
+   *
+   * @tparam PrepareWorker the class of a function to prepare each worker.
+   * @param prepare a function that returns the measured work of a worker.
+   */
+  template <class PrepareWorker>
+  void
+  Run(const PrepareWorker &prepare) const
+  {
+    if (!output_as_csv_) std::cout << "*** START " << target_name_ << " ***" << std::endl;
+
+    std::mt19937_64 rand_engine{random_seed_};
+    std::atomic_size_t ready_num{0};
+    std::atomic_bool start{false};
+
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < thread_num_; ++i) {
+      const size_t n = (exec_num_ + i) / thread_num_;
+      threads.emplace_back([&, i, n, seed = rand_engine()] {
+        if (placement_.PinWorkers()) placement_.PinThread(i);
+        const auto &work = prepare(i, n, seed);
+        ready_num.fetch_add(1, std::memory_order_release);
+        while (!start.load(std::memory_order_acquire)) {
+          // wait for the other workers
+        }
+        work();
+      });
+    }
+
+    while (ready_num.load(std::memory_order_acquire) < thread_num_) {
+      std::this_thread::yield();
+    }
+    const auto start_time = Clock_t::now();
+    start.store(true, std::memory_order_release);
+    for (auto &&t : threads) t.join();
+    const auto elapsed = std::chrono::duration<double>(Clock_t::now() - start_time).count();
+
+    const auto throughput = exec_num_ / elapsed;
+    if (output_as_csv_) {
+      std::cout << throughput << std::endl;
+    } else {
+      std::cout << "Throughput [Ops/s]: " << throughput << std::endl;
+    }
+  }
+
+ private:
+  /*################################################################################################
+   * Internal member variables
+   *##############################################################################################*/
+
+  /// placement of worker threads
+  const NUMAPlacement &placement_;
+
+  /// the total number of operations
+  const size_t exec_num_;
+
+  /// the number of worker threads
+  const size_t thread_num_;
+
+  /// a base random seed
+  const size_t random_seed_;
+
+  /// a flag to output results as CSV format
+  const bool output_as_csv_;
+
+  /// the name of a benchmark target
+  const std::string target_name_;
+};
+
+#endif  // MWCAS_BENCHMARK_THREAD_DRIVER_H
@@ -0,0 +1,284 @@
+/*
+ * Copyright 2021 Database Group, Nagoya University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MWCAS_BENCHMARK_UPDATE_FUNCTION_H
+#define MWCAS_BENCHMARK_UPDATE_FUNCTION_H
+
+#include <x86intrin.h>
+
+#include <algorithm>
+#include <array>
+#include <string>
+
+#include "common.hpp"
+
+/*##################################################################################################
+ * Global enums
+ *################################################################################################*/
+
+/**
+ * @brief Kinds of new values that MwCAS operations install.
+ *
+ */
+enum UpdateKind
+{
+  /// add one to each target word
+  kIncrement,
+  /// rotate the values of target words (i.e., swap pointers among targets)
+  kPointerSwap,
+  /// keep the pointer part of each target word and bump its version tag
+  kVersionBump,
+  /// add one to each target word only if the first target word is even
+  kConditional,
+};
+
+/**
+ * @brief A class to compute new values of target words after calibrated think time.
+ *
+ * Think time emulates computation between reading old values and issuing an MwCAS operation,
+ * which widens the window in which concurrent operations can invalidate the old values.
+ */
+class UpdateFunction
+{
+ public:
+  /*################################################################################################
+   * Type aliases
+   *##############################################################################################*/
+
+  using Values_t = std::array<size_t, kTargetNum>;
+
+  /*################################################################################################
+   * Public constants
+   *##############################################################################################*/
+
+  /// the position of a version tag in a tagged pointer (upper bits are left for MwCAS flags)
+  static constexpr size_t kVersionShift = 48;
+
+  /// a mask to extract a version tag after shifting
+  static constexpr size_t kVersionMask = (1UL << 12UL) - 1;
+
+  /// a mask to extract the pointer part of a tagged pointer
+  static constexpr size_t kPointerMask = (1UL << kVersionShift) - 1;
+
+  /*################################################################################################
+   * Public constructors and assignment operators
+   *##############################################################################################*/
+
+  /**
+   * @brief Construct a new UpdateFunction object.
+   *
+   * @param kind the kind of new values.
+   * @param think_cycles the number of (TSC) cycles of computation before each MwCAS.
+   */
+  UpdateFunction(  //
+      const UpdateKind kind,
+      const size_t think_cycles)
+      : kind_{kind},
+        think_cycles_{think_cycles},
+        think_iterations_{(think_cycles == 0) ? 0 : CalibrateThinkIterations(think_cycles)}
+  {
+  }
+
+  constexpr UpdateFunction(const UpdateFunction &) = default;
+  constexpr UpdateFunction &operator=(const UpdateFunction &obj) = default;
+  constexpr UpdateFunction(UpdateFunction &&) = default;
+  constexpr UpdateFunction &operator=(UpdateFunction &&) = default;
+
+  /*################################################################################################
+   * Public destructors
+   *##############################################################################################*/
+
+  ~UpdateFunction() = default;
+
+  /*################################################################################################
+   * Public getters
+   *##############################################################################################*/
+
+  constexpr UpdateKind
+  GetKind() const
+  {
+    return kind_;
+  }
+
+  constexpr size_t
+  GetThinkCycles() const
+  {
+    return think_cycles_;
+  }
+
+  /**
+   * @retval true if target words should be initialized as distinct pointers.
+   * @retval false if target words should be initialized as zeros.
+   */
+  constexpr bool
+  UsesPointers() const
+  {
+    return kind_ == kPointerSwap || kind_ == kVersionBump;
+  }
+
+  /*################################################################################################
+   * Public utility functions
+   *##############################################################################################*/
+
+  /**
+   * @brief Spend calibrated computation that depends on the read values.
+   *
+   * @param old_vals the old values of target words.
+   */
+  void
+  Think(const Values_t &old_vals) const
+  {
+    if (think_iterations_ == 0) return;
+    think_sink_ = Compute(old_vals[0], think_iterations_);
+  }
+
+  /**
+   * @param old_vals the old values of target words.
+   * @retval true if an MwCAS operation should install new values.
+   * @retval false if the operation completes without any update.
+   */
+  constexpr bool
+  Holds(const Values_t &old_vals) const
+  {
+    return kind_ != kConditional || (old_vals[0] & 1UL) == 0;
+  }
+
+  /**
+   * @param old_vals the old values of target words.
+   * @param width the number of active target words.
+   * @param i the position of a target word.
+   * @return the new value of the i-th target word.
+   */
+  constexpr size_t
+  GetNewValue(  //
+      const Values_t &old_vals,
+      const size_t width,
+      const size_t i) const
+  {
+    switch (kind_) {
+      case kPointerSwap:
+        return old_vals[(i + 1 == width) ? 0 : i + 1];
+      case kVersionBump: {
+        const auto version = ((old_vals[i] >> kVersionShift) + 1) & kVersionMask;
+        return (old_vals[i] & kPointerMask) | (version << kVersionShift);
+      }
+      case kIncrement:
+      case kConditional:
+      default:
+        return old_vals[i] + 1;
+    }
+  }
+
+  /**
+   * @brief Parse an update kind string.
+   *
+   * @param str a kind string ("increment", "pointer_swap", "version_bump", or "conditional").
+   * @param kind a parsed kind.
+   * @retval true if the string is valid.
+   * @retval false otherwise.
+   */
+  static bool
+  Parse(  //
+      const std::string &str,
+      UpdateKind &kind)
+  {
+    if (str == "increment") {
+      kind = kIncrement;
+    } else if (str == "pointer_swap") {
+      kind = kPointerSwap;
+    } else if (str == "version_bump") {
+      kind = kVersionBump;
+    } else if (str == "conditional") {
+      kind = kConditional;
+    } else {
+      return false;
+    }
+    return true;
+  }
+
+ private:
+  /*################################################################################################
+   * Internal constants
+   *##############################################################################################*/
+
+  /// the number of iterations to calibrate think time
+  static constexpr size_t kCalibrationIterations = 1UL << 20UL;
+
+  /*################################################################################################
+   * Internal utility functions
+   *##############################################################################################*/
+
+  /**
+   * @brief Run a chain of dependent xorshift steps that compilers cannot fold.
+   *
+   * @param seed an initial value.
+   * @param iterations the number of steps.
+   * @return the last value of the chain.
+   */
+  static size_t
+  Compute(  //
+      size_t seed,
+      const size_t iterations)
+  {
+    auto x = seed | 1UL;
+    for (size_t i = 0; i < iterations; ++i) {
+      x ^= x << 13UL;
+      x ^= x >> 7UL;
+      x ^= x << 17UL;
+    }
+    return x;
+  }
+
+  /**
+   * @param think_cycles the number of (TSC) cycles to be spent.
+   * @return the number of Compute iterations that take the given cycles.
+   */
+  static size_t
+  CalibrateThinkIterations(const size_t think_cycles)
+  {
+    // take the fastest of a few trials to exclude interruptions
+    auto min_cycles = ~0UL;
+    for (size_t i = 0; i < 3; ++i) {
+      const auto begin = __rdtsc();
+      think_sink_ = Compute(begin, kCalibrationIterations);
+      min_cycles = std::min<size_t>(min_cycles, __rdtsc() - begin);
+    }
+    const auto iterations = static_cast<double>(think_cycles) * kCalibrationIterations / min_cycles;
+    return std::max<size_t>(iterations, 1);
+  }
+
+  /*################################################################################################
+   * Internal static variables
+   *##############################################################################################*/
+
+  /// a sink to prevent think time from being optimized away
+  static inline thread_local volatile size_t think_sink_{0};
+
+  /*################################################################################################
+   * Internal member variables
+   *##############################################################################################*/
+
+  /// the kind of new values
+  UpdateKind kind_;
+
+  /// the requested think time in cycles
+  size_t think_cycles_;
+
+  /// the number of Compute iterations for think time
+  size_t think_iterations_;
+};
+
+#endif  // MWCAS_BENCHMARK_UPDATE_FUNCTION_H
@@ -0,0 +1,174 @@
+/*
+ * Copyright 2021 Database Group, Nagoya University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MWCAS_BENCHMARK_WIDTH_DISTRIBUTION_H
+#define MWCAS_BENCHMARK_WIDTH_DISTRIBUTION_H
+
+#include <algorithm>
+#include <array>
+#include <random>
+#include <sstream>
+#include <string>
+
+#include "common.hpp"
+
+/**
+ * @brief A class to select the number of target words of each MwCAS operation.
+ *
+ * A distribution is given as weighted widths (e.g., "1:70,2:20,3:10"). If only one width is
+ * used, no randomness is consumed so that operations are the same as those with fixed widths.
+ */
+class WidthDistribution
+{
+ public:
+  /*################################################################################################
+   * Type aliases
+   *##############################################################################################*/
+
+  /// weights of widths (the i-th weight is for width i, and index zero is unused)
+  using Weights_t = std::array<double, kTargetNum + 1>;
+
+  /*################################################################################################
+   * Public constructors and assignment operators
+   *##############################################################################################*/
+
+  /**
+   * @brief Construct a new WidthDistribution object.
+   *
+   * @param weights weights of widths (all zero means kTargetNum words).
+   */
+  explicit WidthDistribution(const Weights_t &weights)
+  {
+    double sum = 0;
+    for (size_t w = 1; w <= kTargetNum; ++w) {
+      sum += weights[w];
+      cumulative_[w] = sum;
+    }
+
+    if (sum == 0) {
+      cumulative_.fill(0);
+      cumulative_[kTargetNum] = 1;
+      fixed_width_ = kTargetNum;
+      return;
+    }
+
+    for (auto &&c : cumulative_) c /= sum;
+    for (size_t w = 1; w <= kTargetNum; ++w) {
+      if (weights[w] == sum) fixed_width_ = w;
+    }
+  }
+
+  WidthDistribution(const WidthDistribution &) = default;
+  WidthDistribution &operator=(const WidthDistribution &obj) = default;
+  WidthDistribution(WidthDistribution &&) = default;
+  WidthDistribution &operator=(WidthDistribution &&) = default;
+
+  /*################################################################################################
+   * Public destructors
+   *##############################################################################################*/
+
+  ~WidthDistribution() = default;
+
+  /*################################################################################################
+   * Public getters
+   *##############################################################################################*/
+
+  /**
+   * @retval true if operations have various widths.
+   * @retval false if every operation has the same width.
+   */
+  bool
+  IsVariable() const
+  {
+    return fixed_width_ == 0;
+  }
+
+  /**
+   * @param width a width in [1, kTargetNum].
+   * @return the probability that an operation has the width.
+   */
+  double
+  GetProbability(const size_t width) const
+  {
+    return cumulative_[width] - cumulative_[width - 1];
+  }
+
+  /*################################################################################################
+   * Public utility functions
+   *##############################################################################################*/
+
+  /**
+   * @tparam RandEngine the class of a random engine.
+   * @param rand_engine a random engine of a calling worker.
+   * @return a selected width in [1, kTargetNum].
+   */
+  template <class RandEngine>
+  size_t
+  operator()(RandEngine &rand_engine) const
+  {
+    if (fixed_width_ > 0) return fixed_width_;
+
+    const auto u = std::uniform_real_distribution<double>{0, 1}(rand_engine);
+    const auto it = std::upper_bound(cumulative_.begin() + 1, cumulative_.end(), u);
+    return std::min<size_t>(std::distance(cumulative_.begin(), it), kTargetNum);
+  }
+
+  /*################################################################################################
+   * Public static utilities
+   *##############################################################################################*/
+
+  /**
+   * @brief Parse a width distribution string.
+   *
+   * @param str weighted widths (e.g., "1:70,2:20,3:10"), or an empty string for kTargetNum.
+   * @param weights parsed weights.
+   * @retval true if the string is valid.
+   * @retval false otherwise.
+   */
+  static bool
+  Parse(  //
+      const std::string &str,
+      Weights_t &weights)
+  {
+    weights.fill(0);
+
+    std::istringstream in{str};
+    std::string entry;
+    while (std::getline(in, entry, ',')) {
+      size_t width = 0;
+      double weight = 0;
+      char colon = 0;
+      std::istringstream entry_in{entry};
+      if (!(entry_in >> width >> colon >> weight) || colon != ':' || !entry_in.eof()) return false;
+      if (width == 0 || width > kTargetNum || weight < 0) return false;
+      weights[width] += weight;
+    }
+    return true;
+  }
+
+ private:
+  /*################################################################################################
+   * Internal member variables
+   *##############################################################################################*/
+
+  /// cumulative probabilities of widths
+  Weights_t cumulative_{};
+
+  /// a width of every operation (zero if widths vary)
+  size_t fixed_width_{0};
+};
+
+#endif  // MWCAS_BENCHMARK_WIDTH_DISTRIBUTION_H
@@ -0,0 +1,117 @@
+/*
+ * Copyright 2021 Database Group, Nagoya University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MWCAS_BENCHMARK_XOSHIRO_H
+#define MWCAS_BENCHMARK_XOSHIRO_H
+
+#include <array>
+#include <limits>
+
+#include "common.hpp"
+
+/**
+ * @brief A small and fast random engine (xoshiro256**) for generating operations on the fly.
+ *
+ * This class satisfies UniformRandomBitGenerator, and so it can be used with distributions
+ * in the standard library instead of std::mt19937_64, whose state does not fit in a few
+ * cache lines.
+ */
+class Xoshiro256
+{
+ public:
+  /*################################################################################################
+   * Type aliases
+   *##############################################################################################*/
+
+  using result_type = uint64_t;
+
+  /*################################################################################################
+   * Public constructors and assignment operators
+   *##############################################################################################*/
+
+  /**
+   * @brief Construct a new Xoshiro256 object.
+   *
+   * @param random_seed a random seed expanded with SplitMix64.
+   */
+  explicit Xoshiro256(uint64_t random_seed)
+  {
+    for (auto &&s : state_) {
+      random_seed += 0x9E3779B97F4A7C15UL;
+      auto z = random_seed;
+      z = (z ^ (z >> 30UL)) * 0xBF58476D1CE4E5B9UL;
+      z = (z ^ (z >> 27UL)) * 0x94D049BB133111EBUL;
+      s = z ^ (z >> 31UL);
+    }
+  }
+
+  /*################################################################################################
+   * Public utility functions
+   *##############################################################################################*/
+
+  static constexpr result_type
+  min()
+  {
+    return std::numeric_limits<result_type>::min();
+  }
+
+  static constexpr result_type
+  max()
+  {
+    return std::numeric_limits<result_type>::max();
+  }
+
+  /**
+   * @return a next random value.
+   */
+  result_type
+  operator()()
+  {
+    const auto result = Rotate(state_[1] * 5, 7) * 9;
+    const auto t = state_[1] << 17UL;
+
+    state_[2] ^= state_[0];
+    state_[3] ^= state_[1];
+    state_[1] ^= state_[2];
+    state_[0] ^= state_[3];
+    state_[2] ^= t;
+    state_[3] = Rotate(state_[3], 45);
+
+    return result;
+  }
+
+ private:
+  /*################################################################################################
+   * Internal utility functions
+   *##############################################################################################*/
+
+  static constexpr uint64_t
+  Rotate(  //
+      const uint64_t x,
+      const int k)
+  {
+    return (x << k) | (x >> (64 - k));
+  }
+
+  /*################################################################################################
+   * Internal member variables
+   *##############################################################################################*/
+
+  /// the internal state of this engine
+  std::array<uint64_t, 4> state_{};
+};
+
+#endif  // MWCAS_BENCHMARK_XOSHIRO_H
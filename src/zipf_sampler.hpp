@@ -0,0 +1,170 @@
+/*
+ * Copyright 2021 Database Group, Nagoya University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MWCAS_BENCHMARK_ZIPF_SAMPLER_H
+#define MWCAS_BENCHMARK_ZIPF_SAMPLER_H
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+#include "common.hpp"
+
+/**
+ * @brief A Zipf sampler with O(1) memory and O(1) expected time per sample.
+ *
+ * This class implements rejection-inversion sampling (W. Hörmann and G. Derflinger,
+ * "Rejection-inversion to generate variates from monotone discrete distributions," ACM TOMACS,
+ * 1996). Unlike a CDF table, its setup and footprint do not depend on the number of ranks, and
+ * so it can select ranks from billions of target fields. Ranks follow the same distribution
+ * as ZipfGenerator (i.e., rank zero is the most frequent).
+ */
+class RejectionInversionZipf
+{
+ public:
+  /*################################################################################################
+   * Public constructors and assignment operators
+   *##############################################################################################*/
+
+  /**
+   * @brief Construct a new RejectionInversionZipf object.
+   *
+   * @param rank_num the number of ranks.
+   * @param skew_parameter a (non-negative) skew parameter of Zipf's law.
+   */
+  RejectionInversionZipf(  //
+      const size_t rank_num,
+      const double skew_parameter)
+      : rank_num_{std::max<size_t>(rank_num, 1)},
+        skew_{skew_parameter},
+        h_integral_x1_{HIntegral(1.5) - 1.0},
+        h_integral_n_{HIntegral(rank_num_ + 0.5)},
+        squeeze_{2.0 - HIntegralInverse(HIntegral(2.5) - H(2.0))}
+  {
+  }
+
+  RejectionInversionZipf(const RejectionInversionZipf &) = default;
+  RejectionInversionZipf &operator=(const RejectionInversionZipf &obj) = default;
+  RejectionInversionZipf(RejectionInversionZipf &&) = default;
+  RejectionInversionZipf &operator=(RejectionInversionZipf &&) = default;
+
+  /*################################################################################################
+   * Public destructors
+   *##############################################################################################*/
+
+  ~RejectionInversionZipf() = default;
+
+  /*################################################################################################
+   * Public utility functions
+   *##############################################################################################*/
+
+  /**
+   * @tparam RandEngine the class of a random engine.
+   * @param rand_engine a random engine of a calling thread.
+   * @return a selected rank in [0, the number of ranks).
+   */
+  template <class RandEngine>
+  size_t
+  operator()(RandEngine &rand_engine) const
+  {
+    std::uniform_real_distribution<double> uniform{0, 1};
+    while (true) {
+      // u is distributed uniformly in (h_integral_x1_, h_integral_n_]
+      const auto u = h_integral_n_ + uniform(rand_engine) * (h_integral_x1_ - h_integral_n_);
+      const auto x = HIntegralInverse(u);
+      const auto k = std::clamp<double>(std::floor(x + 0.5), 1.0, rank_num_);
+      if (k - x <= squeeze_ || u >= HIntegral(k + 0.5) - H(k)) {
+        return static_cast<size_t>(k) - 1;
+      }
+    }
+  }
+
+ private:
+  /*################################################################################################
+   * Internal utility functions
+   *##############################################################################################*/
+
+  /**
+   * @return the (unnormalized) density h(x) = x^(-s).
+   */
+  double
+  H(const double x) const
+  {
+    return std::exp(-skew_ * std::log(x));
+  }
+
+  /**
+   * @return an integral of h, i.e., (x^(1-s) - 1) / (1 - s) or log(x) if s = 1.
+   */
+  double
+  HIntegral(const double x) const
+  {
+    const auto log_x = std::log(x);
+    return ExpM1Div((1.0 - skew_) * log_x) * log_x;
+  }
+
+  /**
+   * @return the inverse function of HIntegral.
+   */
+  double
+  HIntegralInverse(const double x) const
+  {
+    // clamp to avoid NaN caused by rounding errors around the lower bound
+    const auto t = std::max(x * (1.0 - skew_), -1.0);
+    return std::exp(Log1pDiv(t) * x);
+  }
+
+  /**
+   * @return log(1 + x) / x, which is continuous around zero.
+   */
+  static double
+  Log1pDiv(const double x)
+  {
+    if (std::abs(x) > 1E-8) return std::log1p(x) / x;
+    return 1.0 - x * (0.5 - x * (1.0 / 3.0 - 0.25 * x));
+  }
+
+  /**
+   * @return (exp(x) - 1) / x, which is continuous around zero.
+   */
+  static double
+  ExpM1Div(const double x)
+  {
+    if (std::abs(x) > 1E-8) return std::expm1(x) / x;
+    return 1.0 + x * 0.5 * (1.0 + x / 3.0 * (1.0 + 0.25 * x));
+  }
+
+  /*################################################################################################
+   * Internal member variables
+   *##############################################################################################*/
+
+  /// the number of ranks
+  size_t rank_num_;
+
+  /// a skew parameter
+  double skew_;
+
+  /// HIntegral(1.5) - h(1)
+  double h_integral_x1_;
+
+  /// HIntegral(the number of ranks + 0.5)
+  double h_integral_n_;
+
+  /// a threshold to accept samples without evaluating HIntegral
+  double squeeze_;
+};
+
+#endif  // MWCAS_BENCHMARK_ZIPF_SAMPLER_H
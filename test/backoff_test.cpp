@@ -0,0 +1,103 @@
+/*
+ * Copyright 2021 Database Group, Nagoya University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "backoff.hpp"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+class BackoffFixture : public ::testing::Test
+{
+ protected:
+  /*################################################################################################
+   * Internal constants
+   *##############################################################################################*/
+
+  static constexpr size_t kThreadNum = 4;
+  static constexpr size_t kIncrementNum = 10000;
+
+  /*################################################################################################
+   * Internal utility functions
+   *##############################################################################################*/
+
+  /**
+   * @brief Increment a shared counter with CAS loops that back off with a given policy.
+   *
+   */
+  template <class Policy>
+  void
+  VerifyCASLoop()
+  {
+    std::atomic_size_t counter{0};
+    std::vector<std::thread> threads{};
+    for (size_t i = 0; i < kThreadNum; ++i) {
+      threads.emplace_back([&counter] {
+        for (size_t j = 0; j < kIncrementNum; ++j) {
+          Policy backoff{};
+          auto old_val = counter.load(std::memory_order_relaxed);
+          while (!counter.compare_exchange_weak(old_val, old_val + 1)) {
+            backoff.Wait();
+          }
+          backoff.Complete();
+        }
+      });
+    }
+    for (auto &&t : threads) t.join();
+
+    EXPECT_EQ(kThreadNum * kIncrementNum, counter.load());
+  }
+};
+
+/*--------------------------------------------------------------------------------------------------
+ * Test definitions
+ *------------------------------------------------------------------------------------------------*/
+
+TEST_F(BackoffFixture, Wait_ContendedCASLoops_AllIncrementsApplied)
+{
+  VerifyCASLoop<NoBackoff>();
+  VerifyCASLoop<ExponentialBackoff>();
+  VerifyCASLoop<RandomizedBackoff>();
+  VerifyCASLoop<YieldBackoff>();
+  VerifyCASLoop<AdaptiveBackoff>();
+}
+
+TEST_F(BackoffFixture, Random_ManyDraws_LowBitsVary)
+{
+  size_t ones = 0;
+  for (size_t i = 0; i < kIncrementNum; ++i) {
+    ones += Backoff::Random() & 1UL;
+  }
+  EXPECT_NEAR(0.5, static_cast<double>(ones) / kIncrementNum, 0.05);
+}
+
+TEST_F(BackoffFixture, Parse_PolicyStrings_ParsedAsPolicies)
+{
+  BackoffPolicy policy{};
+  EXPECT_TRUE(Backoff::Parse("none", policy));
+  EXPECT_EQ(kNoBackoff, policy);
+  EXPECT_TRUE(Backoff::Parse("exponential", policy));
+  EXPECT_EQ(kExponentialBackoff, policy);
+  EXPECT_TRUE(Backoff::Parse("randomized", policy));
+  EXPECT_EQ(kRandomizedBackoff, policy);
+  EXPECT_TRUE(Backoff::Parse("yield", policy));
+  EXPECT_EQ(kYieldBackoff, policy);
+  EXPECT_TRUE(Backoff::Parse("adaptive", policy));
+  EXPECT_EQ(kAdaptiveBackoff, policy);
+  EXPECT_FALSE(Backoff::Parse("linear", policy));
+}
@@ -0,0 +1,79 @@
+/*
+ * Copyright 2021 Database Group, Nagoya University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "descriptor_probe.hpp"
+
+#include <array>
+
+#include "gtest/gtest.h"
+#include "update_function.hpp"
+
+/*--------------------------------------------------------------------------------------------------
+ * Global utility functions
+ *------------------------------------------------------------------------------------------------*/
+
+Operation
+CreateOperation(  //
+    std::array<uint64_t, kTargetNum> &words,
+    const OperationType type)
+{
+  std::array<uint64_t *, kTargetNum> targets{};
+  for (size_t i = 0; i < kTargetNum; ++i) {
+    targets[i] = &words[i];
+  }
+  return Operation{targets, kTargetNum, type};
+}
+
+/*--------------------------------------------------------------------------------------------------
+ * Test definitions
+ *------------------------------------------------------------------------------------------------*/
+
+TEST(DescriptorProbeTest, IsDescriptor_BenchmarkValues_NotDescriptors)
+{
+  constexpr auto kMaxVersion = UpdateFunction::kVersionMask << UpdateFunction::kVersionShift;
+
+  EXPECT_FALSE(DescriptorProbe::IsDescriptor(0));
+  EXPECT_FALSE(DescriptorProbe::IsDescriptor(kMaxVersion | UpdateFunction::kPointerMask));
+  EXPECT_TRUE(DescriptorProbe::IsDescriptor(1UL << 63UL));
+  EXPECT_TRUE(DescriptorProbe::IsDescriptor(1UL << DescriptorProbe::kFlagShift));
+}
+
+TEST(DescriptorProbeTest, PeekRead_FlaggedWord_HitsCountedByType)
+{
+  std::array<uint64_t, kTargetNum> words{};
+  DescriptorProbe probe{};
+
+  probe.PeekRead(CreateOperation(words, kRead));
+  probe.PeekRead(CreateOperation(words, kUpdate));
+  words[kTargetNum - 1] = 1UL << 63UL;
+  probe.PeekRead(CreateOperation(words, kRead));
+  probe.PeekRead(CreateOperation(words, kUpdate));
+  probe.PeekFailure(CreateOperation(words, kUpdate));
+
+  EXPECT_EQ(2, probe.GetReadNum());
+  EXPECT_EQ(1, probe.GetReadHitNum());
+  EXPECT_EQ(2, probe.GetAttemptNum());
+  EXPECT_EQ(1, probe.GetAttemptHitNum());
+  EXPECT_EQ(2, probe.GetWordHitNum());
+  EXPECT_EQ(1, probe.GetFailureNum());
+  EXPECT_EQ(1, probe.GetFailureHitNum());
+
+  DescriptorProbe total{};
+  total.Merge(probe);
+  total.Merge(probe);
+  EXPECT_EQ(4, total.GetReadNum());
+  EXPECT_EQ(2, total.GetFailureHitNum());
+}
@@ -0,0 +1,180 @@
+/*
+ * Copyright 2021 Database Group, Nagoya University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "key_distribution.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+class KeyDistributionFixture : public ::testing::Test
+{
+ protected:
+  /*################################################################################################
+   * Internal constants
+   *##############################################################################################*/
+
+  static constexpr size_t kFieldNum = 1000;
+  static constexpr size_t kSampleNum = 1E5;
+  static constexpr size_t kRandomSeed = 10;
+  static constexpr double kSkewParameter = 1.0;
+  static constexpr double kHotOpRatio = 0.9;
+  static constexpr double kHotFieldRatio = 0.1;
+  static constexpr size_t kHotspotPeriod = 100;
+  static constexpr double kExpLambda = 10.0;
+  static constexpr size_t kPartitionNum = 4;
+  static constexpr double kConflictRate = 0.25;
+  static constexpr size_t kSharedFieldNum = kTargetNum;
+
+  /*################################################################################################
+   * Internal utility functions
+   *##############################################################################################*/
+
+  KeyDistribution
+  CreateDistribution(const KeyDistType dist_type)
+  {
+    return KeyDistribution{dist_type,     kFieldNum,      kSkewParameter, kHotOpRatio,
+                           kHotFieldRatio, kHotspotPeriod, kExpLambda,     kPartitionNum,
+                           kConflictRate,  kSharedFieldNum};
+  }
+
+  /*################################################################################################
+   * Internal member variables
+   *##############################################################################################*/
+
+  std::mt19937_64 rand_engine_{kRandomSeed};
+};
+
+/*--------------------------------------------------------------------------------------------------
+ * Test definitions
+ *------------------------------------------------------------------------------------------------*/
+
+TEST_F(KeyDistributionFixture, Select_Uniform_RanksAreInRange)
+{
+  auto key_dist = CreateDistribution(kUniform);
+
+  for (size_t i = 0; i < kSampleNum; ++i) {
+    EXPECT_LT(key_dist(rand_engine_, 0, i), kFieldNum);
+  }
+}
+
+TEST_F(KeyDistributionFixture, Select_Hotspot_HotRanksAreSelectedWithHotRatio)
+{
+  auto key_dist = CreateDistribution(kHotspot);
+  const size_t hot_num = kFieldNum * kHotFieldRatio;
+
+  size_t hot_count = 0;
+  for (size_t i = 0; i < kSampleNum; ++i) {
+    if (key_dist(rand_engine_, 0, i) < hot_num) ++hot_count;
+  }
+  EXPECT_NEAR(kHotOpRatio, static_cast<double>(hot_count) / kSampleNum, 0.01);
+}
+
+TEST_F(KeyDistributionFixture, Select_MovingHotspot_HotspotShiftsEachPeriod)
+{
+  auto key_dist = CreateDistribution(kMovingHotspot);
+  const size_t hot_num = kFieldNum * kHotFieldRatio;
+
+  size_t hot_count = 0;
+  for (size_t i = 0; i < kSampleNum; ++i) {
+    const auto hot_begin = (i / kHotspotPeriod) * hot_num % kFieldNum;
+    const auto rank = key_dist(rand_engine_, 0, i);
+    if ((rank + kFieldNum - hot_begin) % kFieldNum < hot_num) ++hot_count;
+  }
+  EXPECT_NEAR(kHotOpRatio, static_cast<double>(hot_count) / kSampleNum, 0.01);
+}
+
+TEST_F(KeyDistributionFixture, Select_Exponential_LowRanksAreFrequent)
+{
+  auto key_dist = CreateDistribution(kExponential);
+
+  size_t low_count = 0;
+  for (size_t i = 0; i < kSampleNum; ++i) {
+    const auto rank = key_dist(rand_engine_, 0, i);
+    ASSERT_LT(rank, kFieldNum);
+    if (rank < kFieldNum / kExpLambda) ++low_count;
+  }
+  // P(X < 1/lambda) = 1 - 1/e for an exponential distribution
+  EXPECT_NEAR(0.632, static_cast<double>(low_count) / kSampleNum, 0.01);
+}
+
+TEST_F(KeyDistributionFixture, Select_Partitioned_WorkersDoNotShareRanks)
+{
+  auto key_dist = CreateDistribution(kPartitioned);
+  constexpr size_t kPartitionSize = kFieldNum / kPartitionNum;
+
+  for (size_t worker_id = 0; worker_id < kPartitionNum; ++worker_id) {
+    for (size_t i = 0; i < kSampleNum / kPartitionNum; ++i) {
+      EXPECT_EQ(worker_id, key_dist(rand_engine_, worker_id, i) / kPartitionSize);
+    }
+  }
+}
+
+TEST_F(KeyDistributionFixture, Select_Conflict_SharedOperationsAchieveConflictRate)
+{
+  auto key_dist = CreateDistribution(kConflict);
+  constexpr size_t kPartitionSize = (kFieldNum - kSharedFieldNum) / kPartitionNum;
+
+  // all the shared fields are selected by every shared operation
+  EXPECT_DOUBLE_EQ(0.5, key_dist.GetSharedOpRatio());
+
+  size_t shared_num = 0;
+  for (size_t i = 0; i < kSampleNum; ++i) {
+    const auto worker_id = i % kPartitionNum;
+    const auto op_draw = key_dist.DrawOperation(rand_engine_);
+    const auto rank = key_dist(rand_engine_, worker_id, i, op_draw);
+    if (rank < kSharedFieldNum) {
+      ++shared_num;
+    } else {
+      EXPECT_EQ(worker_id, (rank - kSharedFieldNum) / kPartitionSize);
+    }
+  }
+  EXPECT_NEAR(key_dist.GetSharedOpRatio(), static_cast<double>(shared_num) / kSampleNum, 0.01);
+}
+
+TEST_F(KeyDistributionFixture, Construct_ConflictWithSingleWordOps_RatioAccountsForWidths)
+{
+  WidthDistribution::Weights_t weights{};
+  weights[1] = 1.0;
+  const KeyDistribution key_dist{kConflict,      kFieldNum,      kSkewParameter, kHotOpRatio,
+                                 kHotFieldRatio, kHotspotPeriod, kExpLambda,     kPartitionNum,
+                                 kConflictRate,  kSharedFieldNum, kZipfTable,
+                                 WidthDistribution{weights}};
+
+  // two single-word operations overlap with probability 1/S
+  const auto expected = std::min(std::sqrt(kConflictRate * kSharedFieldNum), 1.0);
+  EXPECT_DOUBLE_EQ(expected, key_dist.GetSharedOpRatio());
+  EXPECT_DOUBLE_EQ(1.0 / kSharedFieldNum, key_dist.GetMaxConflictRate());
+}
+
+TEST_F(KeyDistributionFixture, Select_ZipfRejectionInversion_TopRankIsMostFrequent)
+{
+  KeyDistribution key_dist{kZipf,          kFieldNum,      kSkewParameter, kHotOpRatio,
+                           kHotFieldRatio, kHotspotPeriod, kExpLambda,     kPartitionNum,
+                           kConflictRate,  kSharedFieldNum, kZipfRejectionInversion};
+
+  std::vector<size_t> counts(kFieldNum, 0);
+  for (size_t i = 0; i < kSampleNum; ++i) {
+    const auto rank = key_dist(rand_engine_, 0, i);
+    ASSERT_LT(rank, kFieldNum);
+    ++counts[rank];
+  }
+  EXPECT_GT(counts[0], counts[1]);
+  EXPECT_GT(counts[1], counts[kFieldNum - 1]);
+}
@@ -0,0 +1,94 @@
+/*
+ * Copyright 2021 Database Group, Nagoya University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mwcas_target.hpp"
+
+#include <array>
+
+#include "gtest/gtest.h"
+
+class MwCASTargetFixture : public ::testing::Test
+{
+ protected:
+  /*################################################################################################
+   * Internal constants
+   *##############################################################################################*/
+
+  static constexpr size_t kWorkerNum = 1;
+
+  // run more operations than the descriptors in PMwCAS's pool
+  static constexpr size_t kExecNum = 4 * kPMwCASDescPerWorker * kWorkerNum;
+
+  /*################################################################################################
+   * Internal utility functions
+   *##############################################################################################*/
+
+  /**
+   * @brief Repeat conditional updates on the same words, all but the first of which are no-ops.
+   *
+   * @tparam Implementation a certain implementation of MwCAS algorithms.
+   */
+  template <class Implementation>
+  void
+  VerifyConditionalNoOps()
+  {
+    const UpdateFunction update{kConditional, 0};
+    MwCASTarget<Implementation> target{
+        kTargetNum, kDenseStride, 0,     WordLayout{0, false}, update, true, kNoBackoff,
+        kNoHugePage, placement_,  false, false, false,         false,  0,    0,
+        false,       1,           kWorkerNum};
+
+    const auto &fields = target.ReferTargetFields();
+    std::array<uint64_t *, kTargetNum> targets{};
+    for (size_t i = 0; i < kTargetNum; ++i) {
+      targets[i] = fields[i];
+    }
+    const Operation ops{targets, kTargetNum, kUpdate};
+    for (size_t i = 0; i < kExecNum; ++i) {
+      target.Execute(ops);
+    }
+
+    // only the first operation finds an even word and installs new values
+    for (size_t i = 0; i < kTargetNum; ++i) {
+      EXPECT_EQ(1, *fields[i]);
+    }
+  }
+
+  /*################################################################################################
+   * Internal member variables
+   *##############################################################################################*/
+
+  const NUMAPlacement placement_{kDefaultPolicy, 0, false};
+};
+
+/*--------------------------------------------------------------------------------------------------
+ * Test definitions
+ *------------------------------------------------------------------------------------------------*/
+
+TEST_F(MwCASTargetFixture, Execute_ConditionalNoOpsWithMwCAS_WordsUpdatedOnce)
+{
+  VerifyConditionalNoOps<MwCAS>();
+}
+
+TEST_F(MwCASTargetFixture, Execute_ConditionalNoOpsWithPMwCAS_DescriptorPoolNotExhausted)
+{
+  VerifyConditionalNoOps<PMwCAS>();
+}
+
+TEST_F(MwCASTargetFixture, Execute_ConditionalNoOpsWithAOPT_WordsUpdatedOnce)
+{
+  VerifyConditionalNoOps<AOPT>();
+}
@@ -0,0 +1,278 @@
+/*
+ * Copyright 2021 Database Group, Nagoya University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "operation_engine.hpp"
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <set>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "xoshiro.hpp"
+
+class OperationEngineFixture : public ::testing::Test
+{
+ protected:
+  /*################################################################################################
+   * Internal constants
+   *##############################################################################################*/
+
+  static constexpr size_t kFieldNum = 4096;
+  static constexpr size_t kExecNum = 1E5;
+  static constexpr size_t kRandomSeed = 10;
+  static constexpr double kSkewParameter = 1.0;
+
+  /*################################################################################################
+   * Setup/Teardown
+   *##############################################################################################*/
+
+  void
+  SetUp() override
+  {
+    fields_ = std::make_unique<TargetFields>(kFieldNum, kDenseStride, 0, kNoHugePage);
+  }
+
+  void
+  TearDown() override
+  {
+    fields_.reset(nullptr);
+  }
+
+  /*################################################################################################
+   * Internal utility functions
+   *##############################################################################################*/
+
+  Operation
+  Decode(const Operation &ops) const
+  {
+    return ops;
+  }
+
+  Operation
+  Decode(const CompactOperation &ops) const
+  {
+    return ops.Decode(*fields_);
+  }
+
+  std::set<uint64_t *>
+  GetHotFields(  //
+      const KeyLayout key_layout,
+      const size_t hot_num)
+  {
+    OperationEngine engine{*fields_,  key_dist_,   width_dist_, 0,
+                           key_layout, kRandomSeed, kNoHugePage, placement_};
+
+    std::map<uint64_t *, size_t> counts{};
+    for (auto &&queued : engine.Generate(kExecNum, kRandomSeed)) {
+      const auto &ops = Decode(queued);
+      for (size_t i = 0; i < kTargetNum; ++i) {
+        ++counts[ops.GetAddr(i)];
+      }
+    }
+
+    std::vector<std::pair<size_t, uint64_t *>> sorted{};
+    for (auto &&[addr, count] : counts) {
+      sorted.emplace_back(count, addr);
+    }
+    std::sort(sorted.rbegin(), sorted.rend());
+
+    std::set<uint64_t *> hot_fields{};
+    for (size_t i = 0; i < hot_num && i < sorted.size(); ++i) {
+      hot_fields.emplace(sorted[i].second);
+    }
+    return hot_fields;
+  }
+
+  /*################################################################################################
+   * Internal member variables
+   *##############################################################################################*/
+
+  std::unique_ptr<TargetFields> fields_{nullptr};
+
+  const NUMAPlacement placement_{kDefaultPolicy, 0, false};
+
+  const KeyDistribution key_dist_{kZipf, kFieldNum, kSkewParameter, 0, 0, 1, 1, 1, 0, 0};
+
+  const WidthDistribution width_dist_{WidthDistribution::Weights_t{}};
+};
+
+/*--------------------------------------------------------------------------------------------------
+ * Test definitions
+ *------------------------------------------------------------------------------------------------*/
+
+TEST_F(OperationEngineFixture, Generate_ClusteredLayout_HotFieldsAreAdjacent)
+{
+  for (auto &&addr : GetHotFields(kClustered, 2)) {
+    EXPECT_LE(addr, (*fields_)[1]);
+  }
+}
+
+TEST_F(OperationEngineFixture, Generate_ScatteredLayout_HotFieldsAreNotAdjacent)
+{
+  const auto &hot_fields = GetHotFields(kScattered, 4);
+
+  size_t adjacent_num = 0;
+  for (auto &&addr : hot_fields) {
+    if (addr < (*fields_)[4]) ++adjacent_num;
+  }
+  EXPECT_LT(adjacent_num, hot_fields.size());
+}
+
+TEST_F(OperationEngineFixture, Generate_PageSpreadLayout_HotFieldsAreInDifferentPages)
+{
+  const auto page_size = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+  const auto &hot_fields = GetHotFields(kPageSpread, 2);
+
+  std::set<uintptr_t> pages{};
+  for (auto &&addr : hot_fields) {
+    pages.emplace(reinterpret_cast<uintptr_t>(addr) / page_size);
+  }
+  EXPECT_EQ(hot_fields.size(), pages.size());
+}
+
+TEST_F(OperationEngineFixture, GenerateBatch_FastRandomEngine_TargetsAreDistinctAndSorted)
+{
+  OperationEngine engine{*fields_,  key_dist_,   width_dist_, 0,
+                         kClustered, kRandomSeed, kNoHugePage, placement_};
+  Xoshiro256 rand_engine{kRandomSeed};
+  std::vector<QueuedOperation> batch(kExecNum);
+
+  engine.GenerateBatch(kExecNum, rand_engine, 0, 0, batch.data());
+  for (auto &&queued : batch) {
+    const auto &ops = Decode(queued);
+    for (size_t i = 0; i < kTargetNum; ++i) {
+      EXPECT_GE(ops.GetAddr(i), (*fields_)[0]);
+      EXPECT_LE(ops.GetAddr(i), (*fields_)[kFieldNum - 1]);
+      if (i > 0) {
+        EXPECT_LT(ops.GetAddr(i - 1), ops.GetAddr(i));
+      }
+    }
+  }
+}
+
+TEST_F(OperationEngineFixture, Generate_VariableWidths_OnlyActiveTargetsAreSet)
+{
+  WidthDistribution::Weights_t weights{};
+  weights[1] = 1;
+  weights[kTargetNum] = 1;
+  const WidthDistribution width_dist{weights};
+  OperationEngine engine{*fields_,  key_dist_,   width_dist,  0,
+                         kClustered, kRandomSeed, kNoHugePage, placement_};
+
+  std::set<size_t> widths{};
+  for (auto &&queued : engine.Generate(kExecNum, kRandomSeed)) {
+    const auto &ops = Decode(queued);
+    widths.emplace(ops.GetWidth());
+    for (size_t i = 1; i < ops.GetWidth(); ++i) {
+      EXPECT_LT(ops.GetAddr(i - 1), ops.GetAddr(i));
+    }
+  }
+  EXPECT_EQ((std::set<size_t>{1, kTargetNum}), widths);
+}
+
+TEST_F(OperationEngineFixture, Generate_ReadRatio_ReadsAreMixedWithRatio)
+{
+  constexpr double kReadRatio = 0.9;
+  OperationEngine engine{*fields_,  key_dist_,   width_dist_, kReadRatio,
+                         kClustered, kRandomSeed, kNoHugePage, placement_};
+
+  size_t read_num = 0;
+  for (auto &&ops : engine.Generate(kExecNum, kRandomSeed)) {
+    if (ops.GetType() == kRead) ++read_num;
+  }
+  EXPECT_NEAR(kReadRatio, static_cast<double>(read_num) / kExecNum, 0.01);
+}
+
+TEST_F(OperationEngineFixture, Generate_PreparedWorkload_WorkloadRestored)
+{
+  constexpr size_t kWorkerNum = 2;
+  OperationEngine engine{*fields_,  key_dist_,   width_dist_, 0,
+                         kClustered, kRandomSeed, kNoHugePage, placement_};
+  const auto &workload = engine.GenerateWorkload(kExecNum, kWorkerNum, kRandomSeed);
+  engine.SetWorkload(&workload);
+
+  for (size_t i = 0; i < kWorkerNum; ++i) {
+    const auto &queue = engine.Generate(workload[i].size(), kRandomSeed, i);
+    ASSERT_EQ(workload[i].size(), queue.size());
+    for (size_t j = 0; j < queue.size(); ++j) {
+      const auto &expected = workload[i][j].Decode(*fields_);
+      const auto &ops = Decode(queue[j]);
+      for (size_t k = 0; k < kTargetNum; ++k) {
+        ASSERT_EQ(expected.GetAddr(k), ops.GetAddr(k));
+      }
+    }
+  }
+}
+
+TEST_F(OperationEngineFixture, Generate_PreparedWorkloadWithoutIDs_QueuesClaimedBySize)
+{
+  constexpr size_t kWorkerNum = 3;
+  OperationEngine engine{*fields_,  key_dist_,   width_dist_, 0,
+                         kClustered, kRandomSeed, kNoHugePage, placement_};
+  const auto &workload = engine.GenerateWorkload(kExecNum, kWorkerNum, kRandomSeed);
+  engine.SetWorkload(&workload);
+
+  // the last queue is the longest one, and so it is claimed even if requested first
+  ASSERT_LT(workload[0].size(), workload[kWorkerNum - 1].size());
+  for (auto &&i : {kWorkerNum - 1, size_t{0}, size_t{1}}) {
+    const auto &queue = engine.Generate(workload[i].size(), kRandomSeed);
+    ASSERT_EQ(workload[i].size(), queue.size());
+    for (size_t j = 0; j < queue.size(); ++j) {
+      const auto &expected = workload[i][j].Decode(*fields_);
+      const auto &ops = Decode(queue[j]);
+      ASSERT_EQ(expected.GetAddr(0), ops.GetAddr(0));
+    }
+  }
+
+  // every queue has been claimed, and so the workload cannot be replayed any more
+  EXPECT_THROW(engine.Generate(workload[0].size(), kRandomSeed), std::runtime_error);
+}
+
+TEST_F(OperationEngineFixture, Generate_WithoutPresort_SameTargetsInGenerationOrder)
+{
+  OperationEngine sorted_engine{*fields_,  key_dist_,   width_dist_, 0,
+                                kClustered, kRandomSeed, kNoHugePage, placement_};
+  OperationEngine unsorted_engine{*fields_,   key_dist_,   width_dist_, 0,    kClustered,
+                                  kRandomSeed, kNoHugePage, placement_,  false};
+
+  const auto &sorted_queue = sorted_engine.Generate(kExecNum, kRandomSeed);
+  const auto &unsorted_queue = unsorted_engine.Generate(kExecNum, kRandomSeed);
+  ASSERT_EQ(sorted_queue.size(), unsorted_queue.size());
+  size_t unsorted_num = 0;
+  for (size_t i = 0; i < sorted_queue.size(); ++i) {
+    const auto &expected = Decode(sorted_queue[i]);
+    auto ops = Decode(unsorted_queue[i]);
+    for (size_t j = 1; j < kTargetNum; ++j) {
+      if (ops.GetAddr(j - 1) > ops.GetAddr(j)) {
+        ++unsorted_num;
+        break;
+      }
+    }
+
+    // sorting in measurement results in the same operations
+    ops.SortTargets();
+    for (size_t j = 0; j < kTargetNum; ++j) {
+      ASSERT_EQ(expected.GetAddr(j), ops.GetAddr(j));
+    }
+  }
+  if constexpr (kTargetNum > 1) {
+    EXPECT_GT(unsorted_num, 0);
+  }
+}
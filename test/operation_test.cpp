@@ -95,3 +95,65 @@ TEST_F(OperationFixture, SortTargets_UniqueAddress_AddressesSorted)
     prev_addr = addr;
   }
 }
+
+TEST_F(OperationFixture, SortTargets_ReadWithPartialWidth_PackedFieldsKept)
+{
+  // a width and a type do not enlarge operations
+  EXPECT_EQ(kTargetNum * sizeof(uint64_t *), sizeof(Operation));
+
+  Operation ops{};
+  const auto width = (kTargetNum > 1) ? kTargetNum - 1 : 1;
+  ops.SetWidth(width);
+  ops.SetType(kRead);
+  for (size_t i = 0; i < width; ++i) {
+    ops.SetAddr(i, addresses[width - 1 - i]);
+  }
+  ops.SortTargets();
+
+  EXPECT_EQ(width, ops.GetWidth());
+  EXPECT_EQ(kRead, ops.GetType());
+  for (size_t i = 1; i < width; ++i) {
+    EXPECT_LT(ops.GetAddr(i - 1), ops.GetAddr(i));
+  }
+}
+
+TEST_F(OperationFixture, SetIndex_DuplicateIndex_SetIndexFail)
+{
+  CompactOperation ops{};
+
+  if constexpr (kTargetNum > 1) {
+    ops.SetIndex(0, 0);
+    EXPECT_FALSE(ops.SetIndex(1, 0));
+  }
+}
+
+TEST_F(OperationFixture, Decode_SortedIndices_AddressesSorted)
+{
+  const TargetFields fields{kTargetNum, kDenseStride, 0, kNoHugePage};
+  CompactOperation ops{};
+
+  for (size_t i = 0; i < kTargetNum; ++i) {
+    EXPECT_TRUE(ops.SetIndex(i, kTargetNum - 1 - i));
+  }
+  ops.SortTargets();
+
+  const auto &decoded = ops.Decode(fields);
+  for (size_t i = 0; i < kTargetNum; ++i) {
+    EXPECT_EQ(fields[i], decoded.GetAddr(i));
+  }
+}
+
+TEST_F(OperationFixture, Decode_ReadOperation_TypeAndWidthKept)
+{
+  const TargetFields fields{kTargetNum, kDenseStride, 0, kNoHugePage};
+  CompactOperation ops{};
+
+  ops.SetWidth(1);
+  ops.SetType(kRead);
+  ops.SetIndex(0, 0);
+
+  const auto &decoded = ops.Decode(fields);
+  EXPECT_EQ(kRead, decoded.GetType());
+  EXPECT_EQ(1, decoded.GetWidth());
+  EXPECT_EQ(fields[0], decoded.GetAddr(0));
+}
@@ -0,0 +1,212 @@
+/*
+ * Copyright 2021 Database Group, Nagoya University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "operation_trace.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "operation_engine.hpp"
+
+class OperationTraceFixture : public ::testing::Test
+{
+ protected:
+  /*################################################################################################
+   * Internal constants
+   *##############################################################################################*/
+
+  static constexpr size_t kFieldNum = 4096;
+  static constexpr size_t kExecNum = 1000;
+  static constexpr size_t kWorkerNum = 3;
+  static constexpr size_t kRandomSeed = 10;
+  static constexpr double kReadRatio = 0.5;
+
+  /*################################################################################################
+   * Setup/Teardown
+   *##############################################################################################*/
+
+  void
+  SetUp() override
+  {
+    fields_ = std::make_unique<TargetFields>(kFieldNum, kDenseStride, 0, kNoHugePage);
+    path_ = ::testing::TempDir() + "operation_trace_test.trace";
+  }
+
+  void
+  TearDown() override
+  {
+    std::remove(path_.c_str());
+    fields_.reset(nullptr);
+  }
+
+  /*################################################################################################
+   * Internal utility functions
+   *##############################################################################################*/
+
+  Operation
+  Decode(const Operation &ops) const
+  {
+    return ops;
+  }
+
+  Operation
+  Decode(const CompactOperation &ops) const
+  {
+    return ops.Decode(*fields_);
+  }
+
+  OperationEngine
+  CreateEngine() const
+  {
+    WidthDistribution::Weights_t weights{};
+    weights[1] = 1;
+    weights[kTargetNum] = 1;
+    return OperationEngine{*fields_,  key_dist_,   WidthDistribution{weights}, kReadRatio,
+                           kClustered, kRandomSeed, kNoHugePage,                placement_};
+  }
+
+  void
+  WriteRecords(  //
+      const size_t field_num,
+      const std::vector<CompactOperation> &records)
+  {
+    std::ofstream out{path_, std::ios::binary};
+    OperationTrace::WriteHeader(out, field_num, records.size());
+    for (auto &&ops : records) {
+      OperationTrace::WriteRecord(out, ops);
+    }
+  }
+
+  /*################################################################################################
+   * Internal member variables
+   *##############################################################################################*/
+
+  std::unique_ptr<TargetFields> fields_{nullptr};
+
+  std::string path_{};
+
+  const NUMAPlacement placement_{kDefaultPolicy, 0, false};
+
+  const KeyDistribution key_dist_{kUniform, kFieldNum, 0, 0, 0, 1, 1, 1, 0, 0};
+};
+
+/*--------------------------------------------------------------------------------------------------
+ * Test definitions
+ *------------------------------------------------------------------------------------------------*/
+
+TEST_F(OperationTraceFixture, Write_GeneratedWorkload_ReplayedAsWorkerQueues)
+{
+  auto &&engine = CreateEngine();
+  const auto &workload = engine.GenerateWorkload(kExecNum, kWorkerNum, kRandomSeed);
+  ASSERT_TRUE(OperationTrace::Write(path_, kFieldNum, workload));
+
+  const OperationTrace trace{path_};
+  ASSERT_TRUE(trace.IsValid()) << trace.GetError();
+  EXPECT_EQ(kFieldNum, trace.GetFieldNum());
+  EXPECT_EQ(kExecNum, trace.GetOpNum());
+  EXPECT_TRUE(trace.HasReads());
+  EXPECT_EQ(kTargetNum > 1, trace.HasVariableWidths());
+
+  // each partition should be the same as a queue generated with the same seed
+  const TraceReplayer replayer{trace, *fields_, kWorkerNum};
+  std::mt19937_64 seed_engine{kRandomSeed};
+  for (size_t i = 0; i < kWorkerNum; ++i) {
+    const auto &expected = engine.Generate((kExecNum + i) / kWorkerNum, seed_engine(), i);
+    std::vector<QueuedOperation> replayed(expected.size());
+    replayer.GenerateBatch(replayed.size(), seed_engine, i, 0, replayed.data());
+
+    for (size_t j = 0; j < expected.size(); ++j) {
+      const auto &expected_ops = Decode(expected[j]);
+      const auto &replayed_ops = Decode(replayed[j]);
+      ASSERT_EQ(expected_ops.GetType(), replayed_ops.GetType());
+      ASSERT_EQ(expected_ops.GetWidth(), replayed_ops.GetWidth());
+      for (size_t k = 0; k < expected_ops.GetWidth(); ++k) {
+        ASSERT_EQ(expected_ops.GetAddr(k), replayed_ops.GetAddr(k));
+      }
+    }
+  }
+}
+
+TEST_F(OperationTraceFixture, OperationTrace_UnsortedRecord_TargetsSorted)
+{
+  CompactOperation ops{};
+  for (size_t i = 0; i < kTargetNum; ++i) {
+    ops.SetIndex(i, kTargetNum - 1 - i);
+  }
+  WriteRecords(kFieldNum, {ops});
+
+  const OperationTrace trace{path_};
+  ASSERT_TRUE(trace.IsValid()) << trace.GetError();
+  CompactOperation read_ops{};
+  ASSERT_TRUE(trace.Read(0, read_ops));
+  for (size_t i = 0; i < kTargetNum; ++i) {
+    EXPECT_EQ(i, read_ops.GetIndex(i));
+  }
+}
+
+TEST_F(OperationTraceFixture, GenerateBatch_UnsortedRecordWithoutPresort_TargetsInRecordOrder)
+{
+  CompactOperation ops{};
+  for (size_t i = 0; i < kTargetNum; ++i) {
+    ops.SetIndex(i, kTargetNum - 1 - i);
+  }
+  WriteRecords(kFieldNum, {ops});
+
+  const OperationTrace trace{path_};
+  ASSERT_TRUE(trace.IsValid()) << trace.GetError();
+  std::mt19937_64 rand_engine{kRandomSeed};
+  for (auto &&presort : {true, false}) {
+    const TraceReplayer replayer{trace, *fields_, 1, presort};
+    CompactOperation replayed{};
+    replayer.GenerateBatch(1, rand_engine, 0, 0, &replayed);
+    for (size_t i = 0; i < kTargetNum; ++i) {
+      EXPECT_EQ((presort) ? i : ops.GetIndex(i), replayed.GetIndex(i));
+    }
+  }
+}
+
+TEST_F(OperationTraceFixture, OperationTrace_OutOfRangeIndex_TraceInvalid)
+{
+  CompactOperation ops{};
+  ops.SetWidth(1);
+  ops.SetIndex(0, kFieldNum);
+  WriteRecords(kFieldNum, {ops});
+
+  const OperationTrace trace{path_};
+  EXPECT_FALSE(trace.IsValid());
+}
+
+TEST_F(OperationTraceFixture, OperationTrace_TruncatedFile_TraceInvalid)
+{
+  CompactOperation ops{};
+  ops.SetWidth(1);
+  WriteRecords(kFieldNum, {ops, ops});
+  truncate(path_.c_str(), sizeof(TraceHeader) + sizeof(OperationTrace::Word_t));
+
+  const OperationTrace trace{path_};
+  EXPECT_FALSE(trace.IsValid());
+}
+
+TEST_F(OperationTraceFixture, OperationTrace_MissingFile_TraceInvalid)
+{
+  const OperationTrace trace{path_};
+  EXPECT_FALSE(trace.IsValid());
+}
@@ -0,0 +1,75 @@
+/*
+ * Copyright 2021 Database Group, Nagoya University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "phase_timer.hpp"
+
+#include <set>
+#include <string>
+
+#include "gtest/gtest.h"
+
+/*--------------------------------------------------------------------------------------------------
+ * Global constants
+ *------------------------------------------------------------------------------------------------*/
+
+constexpr size_t kSpinCycles = 100000;
+
+/*--------------------------------------------------------------------------------------------------
+ * Global utility functions
+ *------------------------------------------------------------------------------------------------*/
+
+void
+SpinCycles(const size_t cycles)
+{
+  const auto begin = __rdtsc();
+  while (__rdtsc() - begin < cycles) {
+    // busy wait
+  }
+}
+
+/*--------------------------------------------------------------------------------------------------
+ * Test definitions
+ *------------------------------------------------------------------------------------------------*/
+
+TEST(PhaseTimerTest, Lap_SpinInPhases_CyclesAttributedToEachPhase)
+{
+  PhaseTimer timer{};
+  timer.Start();
+  SpinCycles(kSpinCycles);
+  timer.Lap(kReadPhase);
+  SpinCycles(2 * kSpinCycles);
+  timer.Lap(kCommitPhase);
+  SpinCycles(kSpinCycles);
+  timer.Lap(kReadPhase);
+
+  const auto &cycles = timer.GetCycles();
+  EXPECT_GE(cycles[kReadPhase], 2 * kSpinCycles);
+  EXPECT_GE(cycles[kCommitPhase], 2 * kSpinCycles);
+  EXPECT_LT(cycles[kCommitPhase], 4 * kSpinCycles);
+  for (size_t i = 0; i < kPhaseNum; ++i) {
+    if (i == kReadPhase || i == kCommitPhase) continue;
+    EXPECT_EQ(0, cycles[i]);
+  }
+}
+
+TEST(PhaseTimerTest, ToString_AllPhases_NamesAreDistinct)
+{
+  std::set<std::string> names{};
+  for (size_t i = 0; i < kPhaseNum; ++i) {
+    names.emplace(ToString(static_cast<Phase>(i)));
+  }
+  EXPECT_EQ(kPhaseNum, names.size());
+}
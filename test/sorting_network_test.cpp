@@ -0,0 +1,96 @@
+/*
+ * Copyright 2021 Database Group, Nagoya University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "sorting_network.hpp"
+
+#include <algorithm>
+#include <array>
+#include <random>
+
+#include "gtest/gtest.h"
+
+class SortingNetworkFixture : public ::testing::Test
+{
+ protected:
+  /*################################################################################################
+   * Internal constants
+   *##############################################################################################*/
+
+  static constexpr size_t kRepeatNum = 1000;
+  static constexpr size_t kRandomSeed = 10;
+
+  /*################################################################################################
+   * Internal utility functions
+   *##############################################################################################*/
+
+  template <size_t N>
+  void
+  VerifySort(const uint64_t max_value)
+  {
+    std::uniform_int_distribution<uint64_t> dist{0, max_value};
+    for (size_t i = 0; i < kRepeatNum; ++i) {
+      std::array<uint64_t, N> elements{};
+      for (auto &&e : elements) e = dist(rand_engine_);
+      auto expected = elements;
+      std::sort(expected.begin(), expected.end());
+
+      SortingNetwork<N>::Sort(elements);
+
+      ASSERT_EQ(expected, elements);
+    }
+  }
+
+  /*################################################################################################
+   * Internal member variables
+   *##############################################################################################*/
+
+  std::mt19937_64 rand_engine_{kRandomSeed};
+};
+
+/*--------------------------------------------------------------------------------------------------
+ * Test definitions
+ *------------------------------------------------------------------------------------------------*/
+
+TEST_F(SortingNetworkFixture, Sort_NarrowArrays_ElementsSorted)
+{
+  VerifySort<1>(~0UL);
+  VerifySort<2>(~0UL);
+  VerifySort<3>(~0UL);
+  VerifySort<5>(~0UL);
+  VerifySort<8>(~0UL);
+}
+
+TEST_F(SortingNetworkFixture, Sort_WideArrays_ElementsSorted)
+{
+  VerifySort<16>(~0UL);
+  VerifySort<33>(~0UL);
+  VerifySort<64>(~0UL);
+}
+
+TEST_F(SortingNetworkFixture, Sort_DuplicateElements_ElementsSorted)
+{
+  VerifySort<7>(2);
+  VerifySort<64>(3);
+}
+
+TEST_F(SortingNetworkFixture, Size_PowerOfTwoWidths_MatchBatcherNetworks)
+{
+  // Batcher's odd-even merge sort uses (p^2 - p + 4) * 2^(p-2) - 1 comparators for 2^p elements
+  EXPECT_EQ(1, SortingNetwork<2>::size());
+  EXPECT_EQ(5, SortingNetwork<4>::size());
+  EXPECT_EQ(19, SortingNetwork<8>::size());
+  EXPECT_EQ(543, SortingNetwork<64>::size());
+}
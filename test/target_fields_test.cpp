@@ -0,0 +1,90 @@
+/*
+ * Copyright 2021 Database Group, Nagoya University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "target_fields.hpp"
+
+#include "gtest/gtest.h"
+
+/*--------------------------------------------------------------------------------------------------
+ * Global constants
+ *------------------------------------------------------------------------------------------------*/
+
+constexpr size_t kFieldNum = 1024;
+
+/*--------------------------------------------------------------------------------------------------
+ * Test definitions
+ *------------------------------------------------------------------------------------------------*/
+
+TEST(TargetFieldsTest, Construct_DenseStride_FieldsArePackedContiguously)
+{
+  TargetFields fields{kFieldNum, kDenseStride, 0, kNoHugePage};
+  fields.Initialize(0, kFieldNum);
+
+  EXPECT_EQ(kFieldNum, fields.size());
+  for (size_t i = 1; i < kFieldNum; ++i) {
+    EXPECT_EQ(fields[i - 1] + 1, fields[i]);
+  }
+}
+
+TEST(TargetFieldsTest, Construct_CacheLineStride_EachFieldHasOwnLine)
+{
+  TargetFields fields{kFieldNum, kCacheLineStride, 0, kNoHugePage};
+  fields.Initialize(0, kFieldNum);
+
+  for (size_t i = 0; i < kFieldNum; ++i) {
+    const auto addr = reinterpret_cast<uintptr_t>(fields[i]);
+    EXPECT_EQ(0, addr % kCacheLineSize);
+    EXPECT_EQ(0, *fields[i]);
+  }
+}
+
+TEST(TargetFieldsTest, Construct_LinePairStride_EachFieldHasOwnLinePair)
+{
+  TargetFields fields{kFieldNum, kLinePairStride, 0, kNoHugePage};
+  fields.Initialize(0, kFieldNum);
+
+  for (size_t i = 0; i < kFieldNum; ++i) {
+    const auto addr = reinterpret_cast<uintptr_t>(fields[i]);
+    EXPECT_EQ(0, addr % kLinePairStride);
+    EXPECT_EQ(0, *fields[i]);
+  }
+}
+
+TEST(TargetFieldsTest, Construct_WordOffset_FieldsAreEmbeddedInRecords)
+{
+  constexpr size_t kRecordSize = 256;
+  constexpr size_t kWordOffset = 16;
+
+  TargetFields fields{kFieldNum, kRecordSize, kWordOffset, kNoHugePage};
+  fields.Initialize(0, kFieldNum);
+
+  const auto head = reinterpret_cast<uintptr_t>(fields.GetRegion());
+  for (size_t i = 0; i < kFieldNum; ++i) {
+    const auto addr = reinterpret_cast<uintptr_t>(fields[i]);
+    EXPECT_EQ(head + i * kRecordSize + kWordOffset, addr);
+    EXPECT_EQ(0, *fields[i]);
+  }
+}
+
+TEST(TargetFieldsTest, Initialize_StoreAddresses_FieldsHoldOwnAddresses)
+{
+  TargetFields fields{kFieldNum, kDenseStride, 0, kNoHugePage};
+  fields.Initialize(0, kFieldNum, true);
+
+  for (size_t i = 0; i < kFieldNum; ++i) {
+    EXPECT_EQ(reinterpret_cast<uint64_t>(fields[i]), *fields[i]);
+  }
+}
@@ -0,0 +1,75 @@
+/*
+ * Copyright 2021 Database Group, Nagoya University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "target_set.hpp"
+
+#include <random>
+#include <set>
+
+#include "gtest/gtest.h"
+
+class TargetSetFixture : public ::testing::Test
+{
+ protected:
+  /*################################################################################################
+   * Internal constants
+   *##############################################################################################*/
+
+  static constexpr size_t kRepeatNum = 1000;
+  static constexpr size_t kRandomSeed = 10;
+
+  /*################################################################################################
+   * Internal utility functions
+   *##############################################################################################*/
+
+  template <size_t N>
+  void
+  VerifyInsert(const size_t field_num)
+  {
+    std::uniform_int_distribution<size_t> dist{0, field_num - 1};
+    for (size_t i = 0; i < kRepeatNum; ++i) {
+      TargetSet<N> selected{};
+      std::set<size_t> expected{};
+      while (expected.size() < N) {
+        const auto slot = dist(rand_engine_);
+        ASSERT_EQ(expected.insert(slot).second, selected.Insert(slot));
+      }
+    }
+  }
+
+  /*################################################################################################
+   * Internal member variables
+   *##############################################################################################*/
+
+  std::mt19937_64 rand_engine_{kRandomSeed};
+};
+
+/*--------------------------------------------------------------------------------------------------
+ * Test definitions
+ *------------------------------------------------------------------------------------------------*/
+
+TEST_F(TargetSetFixture, Insert_NarrowOperations_DuplicatesRejected)
+{
+  VerifyInsert<2>(4);
+  VerifyInsert<8>(16);
+}
+
+TEST_F(TargetSetFixture, Insert_WideOperations_DuplicatesRejected)
+{
+  VerifyInsert<16>(32);
+  VerifyInsert<64>(128);
+  VerifyInsert<64>(~0UL);
+}
@@ -0,0 +1,120 @@
+/*
+ * Copyright 2021 Database Group, Nagoya University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "update_function.hpp"
+
+#include "gtest/gtest.h"
+
+class UpdateFunctionFixture : public ::testing::Test
+{
+ protected:
+  /*################################################################################################
+   * Internal utility functions
+   *##############################################################################################*/
+
+  static UpdateFunction::Values_t
+  GetOldValues()
+  {
+    UpdateFunction::Values_t old_vals{};
+    for (size_t i = 0; i < kTargetNum; ++i) {
+      // emulate tagged pointers with a version tag of i
+      old_vals[i] = ((i + 1) * 64) | (i << UpdateFunction::kVersionShift);
+    }
+    return old_vals;
+  }
+};
+
+/*--------------------------------------------------------------------------------------------------
+ * Test definitions
+ *------------------------------------------------------------------------------------------------*/
+
+TEST_F(UpdateFunctionFixture, GetNewValue_Increment_AddOneToEachWord)
+{
+  const UpdateFunction update{kIncrement, 0};
+  const auto &old_vals = GetOldValues();
+
+  EXPECT_TRUE(update.Holds(old_vals));
+  for (size_t i = 0; i < kTargetNum; ++i) {
+    EXPECT_EQ(old_vals[i] + 1, update.GetNewValue(old_vals, kTargetNum, i));
+  }
+}
+
+TEST_F(UpdateFunctionFixture, GetNewValue_PointerSwap_ValuesRotated)
+{
+  const UpdateFunction update{kPointerSwap, 0};
+  const auto &old_vals = GetOldValues();
+
+  EXPECT_TRUE(update.UsesPointers());
+  for (size_t i = 0; i < kTargetNum; ++i) {
+    EXPECT_EQ(old_vals[(i + 1) % kTargetNum], update.GetNewValue(old_vals, kTargetNum, i));
+  }
+}
+
+TEST_F(UpdateFunctionFixture, GetNewValue_VersionBump_PointerKeptAndVersionIncremented)
+{
+  const UpdateFunction update{kVersionBump, 0};
+  auto old_vals = GetOldValues();
+  old_vals[0] |= UpdateFunction::kVersionMask << UpdateFunction::kVersionShift;
+
+  for (size_t i = 0; i < kTargetNum; ++i) {
+    const auto new_val = update.GetNewValue(old_vals, kTargetNum, i);
+    EXPECT_EQ(old_vals[i] & UpdateFunction::kPointerMask, new_val & UpdateFunction::kPointerMask);
+    const auto version = (i == 0) ? 0 : i + 1;  // a version wraps around within its bits
+    EXPECT_EQ(version << UpdateFunction::kVersionShift, new_val & ~UpdateFunction::kPointerMask);
+  }
+}
+
+TEST_F(UpdateFunctionFixture, Holds_Conditional_OnlyEvenFirstWordsAreUpdated)
+{
+  const UpdateFunction update{kConditional, 0};
+  auto old_vals = GetOldValues();
+
+  EXPECT_TRUE(update.Holds(old_vals));
+  EXPECT_EQ(old_vals[0] + 1, update.GetNewValue(old_vals, kTargetNum, 0));
+  ++old_vals[0];
+  EXPECT_FALSE(update.Holds(old_vals));
+}
+
+TEST_F(UpdateFunctionFixture, Think_CalibratedCycles_TakeRequestedCycles)
+{
+  constexpr size_t kThinkCycles = 100000;
+  const UpdateFunction update{kIncrement, kThinkCycles};
+  const auto &old_vals = GetOldValues();
+
+  // take the fastest of a few trials to exclude interruptions
+  auto min_cycles = ~0UL;
+  for (size_t i = 0; i < 5; ++i) {
+    const auto begin = __rdtsc();
+    update.Think(old_vals);
+    min_cycles = std::min<size_t>(min_cycles, __rdtsc() - begin);
+  }
+  EXPECT_GT(min_cycles, kThinkCycles / 2);
+  EXPECT_LT(min_cycles, kThinkCycles * 2);
+}
+
+TEST_F(UpdateFunctionFixture, Parse_KindStrings_ParsedAsKinds)
+{
+  UpdateKind kind{};
+  EXPECT_TRUE(UpdateFunction::Parse("increment", kind));
+  EXPECT_EQ(kIncrement, kind);
+  EXPECT_TRUE(UpdateFunction::Parse("pointer_swap", kind));
+  EXPECT_EQ(kPointerSwap, kind);
+  EXPECT_TRUE(UpdateFunction::Parse("version_bump", kind));
+  EXPECT_EQ(kVersionBump, kind);
+  EXPECT_TRUE(UpdateFunction::Parse("conditional", kind));
+  EXPECT_EQ(kConditional, kind);
+  EXPECT_FALSE(UpdateFunction::Parse("decrement", kind));
+}
@@ -0,0 +1,80 @@
+/*
+ * Copyright 2021 Database Group, Nagoya University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "width_distribution.hpp"
+
+#include <random>
+#include <string>
+
+#include "gtest/gtest.h"
+
+class WidthDistributionFixture : public ::testing::Test
+{
+ protected:
+  /*################################################################################################
+   * Internal constants
+   *##############################################################################################*/
+
+  static constexpr size_t kSampleNum = 1E5;
+  static constexpr size_t kRandomSeed = 10;
+
+  /*################################################################################################
+   * Internal member variables
+   *##############################################################################################*/
+
+  std::mt19937_64 rand_engine_{kRandomSeed};
+};
+
+/*--------------------------------------------------------------------------------------------------
+ * Test definitions
+ *------------------------------------------------------------------------------------------------*/
+
+TEST_F(WidthDistributionFixture, Parse_EmptyString_UseAllTargets)
+{
+  WidthDistribution::Weights_t weights;
+  ASSERT_TRUE(WidthDistribution::Parse("", weights));
+
+  const WidthDistribution width_dist{weights};
+  EXPECT_FALSE(width_dist.IsVariable());
+  EXPECT_EQ(kTargetNum, width_dist(rand_engine_));
+}
+
+TEST_F(WidthDistributionFixture, Parse_InvalidStrings_ParseFail)
+{
+  WidthDistribution::Weights_t weights;
+  EXPECT_FALSE(WidthDistribution::Parse("0:10", weights));
+  EXPECT_FALSE(WidthDistribution::Parse(std::to_string(kTargetNum + 1) + ":10", weights));
+  EXPECT_FALSE(WidthDistribution::Parse("1-10", weights));
+  EXPECT_FALSE(WidthDistribution::Parse("1:", weights));
+}
+
+TEST_F(WidthDistributionFixture, Select_WeightedWidths_WidthsFollowWeights)
+{
+  WidthDistribution::Weights_t weights;
+  ASSERT_TRUE(WidthDistribution::Parse("1:70," + std::to_string(kTargetNum) + ":30", weights));
+  if constexpr (kTargetNum == 1) return;
+
+  const WidthDistribution width_dist{weights};
+  EXPECT_TRUE(width_dist.IsVariable());
+
+  size_t one_num = 0;
+  for (size_t i = 0; i < kSampleNum; ++i) {
+    const auto width = width_dist(rand_engine_);
+    ASSERT_TRUE(width == 1 || width == kTargetNum);
+    if (width == 1) ++one_num;
+  }
+  EXPECT_NEAR(0.7, static_cast<double>(one_num) / kSampleNum, 0.01);
+}
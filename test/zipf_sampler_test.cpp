@@ -0,0 +1,146 @@
+/*
+ * Copyright 2021 Database Group, Nagoya University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "zipf_sampler.hpp"
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "random/zipf.hpp"
+
+class ZipfSamplerFixture : public ::testing::Test
+{
+ protected:
+  /*################################################################################################
+   * Type aliases
+   *##############################################################################################*/
+
+  using ZipfGenerator = ::dbgroup::random::zipf::ZipfGenerator;
+
+  /*################################################################################################
+   * Internal constants
+   *##############################################################################################*/
+
+  static constexpr size_t kRankNum = 100;
+  static constexpr size_t kSampleNum = 1E6;
+  static constexpr size_t kRandomSeed = 10;
+
+  /// the 99.9th percentile of the chi-squared distribution with (kRankNum - 1) degrees
+  static constexpr double kChiSquaredLimit = 148.2;
+
+  /// an upper bound of the total variation distance between two empirical distributions
+  static constexpr double kDistanceLimit = 0.02;
+
+  /*################################################################################################
+   * Internal utility functions
+   *##############################################################################################*/
+
+  template <class Sampler>
+  std::vector<double>
+  GetFrequencies(Sampler &sampler)
+  {
+    std::vector<double> freqs(kRankNum, 0);
+    for (size_t i = 0; i < kSampleNum; ++i) {
+      const auto rank = sampler(rand_engine_);
+      EXPECT_LT(rank, kRankNum);
+      if (rank < kRankNum) ++freqs[rank];
+    }
+    for (auto &&f : freqs) f /= kSampleNum;
+    return freqs;
+  }
+
+  void
+  VerifySampler(const double skew_parameter)
+  {
+    std::vector<double> probs(kRankNum);
+    double sum = 0;
+    for (size_t i = 0; i < kRankNum; ++i) {
+      probs[i] = std::pow(i + 1.0, -skew_parameter);
+      sum += probs[i];
+    }
+    for (auto &&p : probs) p /= sum;
+
+    RejectionInversionZipf sampler{kRankNum, skew_parameter};
+    const auto &freqs = GetFrequencies(sampler);
+    ZipfGenerator table_sampler{kRankNum, skew_parameter};
+    const auto &table_freqs = GetFrequencies(table_sampler);
+
+    // a chi-squared test against exact probabilities
+    double chi_squared = 0;
+    for (size_t i = 0; i < kRankNum; ++i) {
+      const auto diff = freqs[i] - probs[i];
+      chi_squared += kSampleNum * diff * diff / probs[i];
+    }
+    EXPECT_LT(chi_squared, kChiSquaredLimit);
+
+    // the existing sampler should result in the same distribution
+    double distance = 0;
+    for (size_t i = 0; i < kRankNum; ++i) {
+      distance += std::abs(freqs[i] - table_freqs[i]) / 2;
+    }
+    EXPECT_LT(distance, kDistanceLimit);
+  }
+
+  /*################################################################################################
+   * Internal member variables
+   *##############################################################################################*/
+
+  std::mt19937_64 rand_engine_{kRandomSeed};
+};
+
+/*--------------------------------------------------------------------------------------------------
+ * Test definitions
+ *------------------------------------------------------------------------------------------------*/
+
+TEST_F(ZipfSamplerFixture, Sample_ZeroSkew_MatchTableSampler)
+{
+  VerifySampler(0.0);
+}
+
+TEST_F(ZipfSamplerFixture, Sample_ModerateSkew_MatchTableSampler)
+{
+  VerifySampler(0.5);
+}
+
+TEST_F(ZipfSamplerFixture, Sample_UnitSkew_MatchTableSampler)
+{
+  VerifySampler(1.0);
+}
+
+TEST_F(ZipfSamplerFixture, Sample_HighSkew_MatchTableSampler)
+{
+  VerifySampler(1.5);
+}
+
+TEST_F(ZipfSamplerFixture, Sample_BillionRanks_TopRankFollowsHarmonicNumber)
+{
+  constexpr size_t kHugeRankNum = 1E9;
+  constexpr size_t kHugeSampleNum = 1E5;
+  RejectionInversionZipf sampler{kHugeRankNum, 1.0};
+
+  size_t top_count = 0;
+  for (size_t i = 0; i < kHugeSampleNum; ++i) {
+    const auto rank = sampler(rand_engine_);
+    ASSERT_LT(rank, kHugeRankNum);
+    if (rank == 0) ++top_count;
+  }
+
+  // the harmonic number of n is approximately ln(n) + the Euler-Mascheroni constant
+  const auto top_prob = 1.0 / (std::log(kHugeRankNum) + 0.5772156649);
+  EXPECT_NEAR(top_prob, static_cast<double>(top_count) / kHugeSampleNum, 0.005);
+}